@@ -40,5 +40,6 @@
  * Open "include/lwdtc/lwdtc_opt.h" and
  * copy & replace here settings you want to change values
  */
+#define LWDTC_CFG_DAY_SPECIAL 1
 
 #endif /* LWDTC_HDR_OPTS_H */
@@ -1,6 +1,8 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <windows.h>
 #include "lwdtc/lwdtc.h"
+#include "lwdtc/lwdtc_excl.h"
 
 typedef struct {
     const char* cron_str;
@@ -101,6 +103,8 @@ extern int cron_basic(void);
 extern int cron_multi(void);
 extern int cron_dt_range(void);
 extern int cron_calc_range(void);
+extern int cron_window(void);
+extern int cron_excl(void);
 
 static const char*
 prv_format_time_to_str(struct tm* dt) {
@@ -113,6 +117,795 @@ prv_format_time_to_str(struct tm* dt) {
 #include <stdint.h>
 #define BIT_SET(map, pos) (map)[(pos) >> 3U] |= (1U << ((pos) & 0x07U))
 
+/* Realistic mix of cron strings, used for match benchmark */
+static const char* bench_match_strs[] = {
+    "0 0 0 * * * *",  "*/5 * * * * * *",   "0 */15 * * * * *",   "0 0 */2 * * * *",   "0 30 9 1 * * *",
+    "0 0 12 * * 0,6 *", "* * * * * 2 *",   "* * 8-17 * * 1-5 *", "* * * * 8 6 *",     "* 0 0 * * 0 *",
+    "0 * 7/1 * * 1 *",  "0 * * * * 2-4 *", "0 * 7-19 * * 5 *",   "0 0-30 19 * * 5 *", "10 15 20 8 * 6 *",
+};
+
+/**
+ * \brief           Benchmark matching of realistic cron mix, with and without flags prepared by the parser
+ */
+static void
+prv_bench_match(void) {
+    lwdtc_cron_ctx_t ctxs[LWDTC_ARRAYSIZE(bench_match_strs)];
+    struct tm tm_time;
+    time_t rawtime;
+    uint32_t cnt;
+
+    lwdtc_cron_parse_multi(ctxs, bench_match_strs, LWDTC_ARRAYSIZE(ctxs), NULL);
+    for (size_t run = 0; run < 2; ++run) {
+        /* Second run checks all fields in fixed order (flags cleared), as reference */
+        if (run == 1) {
+            for (size_t i = 0; i < LWDTC_ARRAYSIZE(ctxs); ++i) {
+                ctxs[i].flags = 0;
+            }
+        }
+
+        cnt = 0;
+        uint64_t time_start = GetTickCount64();
+        for (size_t i = 0; i < 1000000; ++i) {
+            rawtime = TIME_T_START + (time_t)i * 7919;
+            localtime_s(&tm_time, &rawtime);
+            for (size_t r = 0; r < 10; ++r) {
+                for (size_t c = 0; c < LWDTC_ARRAYSIZE(ctxs); ++c) {
+                    cnt += lwdtc_cron_is_valid_for_time(&tm_time, &ctxs[c]) == lwdtcOK;
+                }
+            }
+        }
+        uint64_t time_end = GetTickCount64();
+        printf("Match benchmark, %s order: tick: %llu, matches: %u\r\n", run == 0 ? "selective" : "fixed",
+               (unsigned long long)(time_end - time_start), (unsigned)cnt);
+    }
+}
+
+/* One cron string per schedule shape, detected by the parser */
+static const char* bench_shape_strs[] = {
+    "*/5 * * * * * *", "0 */15 * * * * *", "0 30 9 * * * *", "0 0 12 * * 1 *", "0 0 0 1 * * *",
+};
+
+/**
+ * \brief           Benchmark next time calculation per schedule shape, against generic search (flags cleared)
+ */
+static void
+prv_bench_shapes(void) {
+    lwdtc_cron_ctx_t ctx;
+    time_t new_time;
+
+    for (size_t c = 0; c < LWDTC_ARRAYSIZE(bench_shape_strs); ++c) {
+        uint64_t ticks[2];
+
+        lwdtc_cron_parse(&ctx, bench_shape_strs[c]);
+        for (size_t run = 0; run < 2; ++run) {
+            if (run == 1) {
+                ctx.flags = 0;
+            }
+
+            uint64_t time_start = GetTickCount64();
+            for (size_t i = 0; i < 200000; ++i) {
+                lwdtc_cron_next(&ctx, TIME_T_START + (time_t)i * 7919, &new_time);
+            }
+            ticks[run] = GetTickCount64() - time_start;
+        }
+        printf("Shape benchmark, cron: %-18s shape tick: %llu, generic tick: %llu\r\n", bench_shape_strs[c],
+               (unsigned long long)ticks[0], (unsigned long long)ticks[1]);
+    }
+}
+
+/**
+ * \brief           Get time of local time string, on 2023-08-28 or the days after
+ * \param[in]       time_str: Local time in `hh:mm:ss` format
+ * \param[in]       day: Number of days after 2023-08-28
+ * \return          Time
+ */
+static time_t
+prv_get_local_time(const char* time_str, uint32_t day) {
+    struct tm tm_time = {.tm_year = 123, .tm_mon = 7, .tm_mday = 28 + (int)day, .tm_isdst = -1};
+    unsigned h, m, s;
+
+    sscanf(time_str, "%u:%u:%u", &h, &m, &s);
+    tm_time.tm_hour = (int)h, tm_time.tm_min = (int)m, tm_time.tm_sec = (int)s;
+    return mktime(&tm_time);
+}
+
+/* Count checks, from local time on 2023-08-28 to local time number of days later, with expected count */
+static const struct {
+    const char* cron_str;
+    const char *from, *to;
+    uint32_t to_day;
+    size_t count;
+} count_entries[] = {
+    {"0 0 3 * * * *", "00:00:00", "00:00:00", 7, 7},          {"0 0 */2 * * * *", "00:00:00", "23:59:59", 0, 11},
+    {"0 50 * * * * *", "10:00:00", "13:00:00", 0, 3},         {"0 15,45 * * * * *", "00:00:00", "00:00:00", 2, 96},
+    {"*/20 5-7 1,13 * * * *", "00:00:00", "23:59:59", 0, 18}, {"30 10 7 * * 1-5 *", "08:00:00", "08:00:00", 7, 5},
+};
+
+/**
+ * \brief           Check \ref lwdtc_cron_count in local time
+ * \return          `0` on success, `-1` otherwise
+ */
+static int
+prv_check_count(void) {
+    lwdtc_cron_ctx_t ctx;
+    size_t count = 0;
+
+    for (size_t i = 0; i < LWDTC_ARRAYSIZE(count_entries); ++i) {
+        lwdtc_cron_parse(&ctx, count_entries[i].cron_str);
+        lwdtc_cron_count(&ctx, prv_get_local_time(count_entries[i].from, 0),
+                         prv_get_local_time(count_entries[i].to, count_entries[i].to_day), &count);
+        if (count != count_entries[i].count) {
+            printf("Count failed: cron: %s, from: %s, to: %s, exp: %u, got: %u\r\n", count_entries[i].cron_str,
+                   count_entries[i].from, count_entries[i].to, (unsigned)count_entries[i].count, (unsigned)count);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Fired between checks at minute and hour boundaries, on 2023-08-28, expected first hit or NULL when not fired.
+ * End that is not after the start is on the next day
+ */
+static const struct {
+    const char* cron_str;
+    const char *from, *to, *hit;
+} fired_between_entries[] = {
+    {"0 59 10 * * * *", "10:59:30", "11:00:10", NULL},
+    {"0 59 10 * * * *", "10:58:30", "10:59:10", "10:59:00"},
+    {"0 17,59 * * * * *", "10:59:30", "11:00:10", NULL},
+    {"0 17,59 * * * * *", "10:59:30", "11:17:10", "11:17:00"},
+    {"30 59 23 * * * *", "23:59:40", "23:59:59", NULL},
+    {"0 0 23 * * * *", "23:00:01", "23:59:59", NULL},
+    {"*/20 59 23 * * * *", "23:58:50", "23:59:59", "23:59:00"},
+    {"0 0 3 * * * *", "23:00:00", "03:00:10", "03:00:00"},
+    {"0 0 */2 * * * *", "23:30:00", "01:59:59", "00:00:00"},
+    {"0 0 3 * * * *", "03:00:01", "02:59:59", NULL},
+};
+
+/**
+ * \brief           Check \ref lwdtc_cron_fired_between at minute and hour boundaries
+ * \return          `0` on success, `-1` otherwise
+ */
+static int
+prv_check_fired_between(void) {
+    lwdtc_cron_ctx_t ctx;
+    time_t t_from, t_to, hit;
+
+    for (size_t i = 0; i < LWDTC_ARRAYSIZE(fired_between_entries); ++i) {
+        lwdtcr_t res;
+        const char* hit_str = NULL;
+
+        lwdtc_cron_parse(&ctx, fired_between_entries[i].cron_str);
+        t_from = prv_get_local_time(fired_between_entries[i].from, 0);
+        if ((t_to = prv_get_local_time(fired_between_entries[i].to, 0)) <= t_from) {
+            t_to = prv_get_local_time(fired_between_entries[i].to, 1);
+        }
+
+        res = lwdtc_cron_fired_between(&ctx, t_from, t_to, &hit);
+        if (res == lwdtcOK) {
+            hit_str = prv_format_time_to_str(localtime(&hit)) + 11;
+        }
+        if ((hit_str == NULL) != (fired_between_entries[i].hit == NULL)
+            || (hit_str != NULL && strcmp(hit_str, fired_between_entries[i].hit) != 0)) {
+            printf("Fired between failed: cron: %s, from: %s, to: %s, exp: %s, got: %s\r\n",
+                   fired_between_entries[i].cron_str, fired_between_entries[i].from, fired_between_entries[i].to,
+                   fired_between_entries[i].hit != NULL ? fired_between_entries[i].hit : "none",
+                   hit_str != NULL ? hit_str : "none");
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* Next times in fixed offset zones, including offsets that are not multiple of half an hour, expected in UTC */
+static const struct {
+    const char* cron_str;
+    int32_t utc_offset;
+    const char* next_str[2];
+} tz_entries[] = {
+    {"0 0 3 * * * *", 20700, {"2023-08-28_21:15:00", "2023-08-29_21:15:00"}},      /* +05:45 */
+    {"0 0 */2 * * * *", 35100, {"2023-08-28_22:15:00", "2023-08-29_00:15:00"}},    /* +09:45 */
+    {"30 10 7 * * 1-5 *", -34200, {"2023-08-29_16:40:30", "2023-08-30_16:40:30"}}, /* -09:30 */
+    {"0 0 0 * * 0 *", 19800, {"2023-09-02_18:30:00", "2023-09-09_18:30:00"}},      /* +05:30 */
+};
+
+/**
+ * \brief           Check \ref lwdtc_cron_tz_table_next in fixed offset zones
+ * \return          `0` on success, `-1` otherwise
+ */
+static int
+prv_check_tz(void) {
+    lwdtc_cron_tz_entry_t entry;
+    lwdtc_tz_t tz = {0};
+    time_t time;
+
+    entry.tz = &tz;
+    for (size_t i = 0; i < LWDTC_ARRAYSIZE(tz_entries); ++i) {
+        lwdtc_cron_parse(&entry.ctx, tz_entries[i].cron_str);
+        tz.utc_offset = tz_entries[i].utc_offset;
+        time = TIME_T_START;
+        for (size_t n = 0; n < LWDTC_ARRAYSIZE(tz_entries[i].next_str); ++n) {
+            const char* time_next = "none";
+
+            if (lwdtc_cron_tz_table_next(&entry, 1, time, &time, NULL) == lwdtcOK) {
+                time_next = prv_format_time_to_str(gmtime(&time));
+            }
+            if (strcmp(time_next, tz_entries[i].next_str[n]) != 0) {
+                printf("Time zone failed: cron: %s, offset: %d, exp: %s, got: %s\r\n", tz_entries[i].cron_str,
+                       (int)tz_entries[i].utc_offset, tz_entries[i].next_str[n], time_next);
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+/* Earliest next time among several contexts, from start time, expected with index of the context */
+static struct {
+    const char* cron_strs[3];
+    const char* next_str;
+    size_t index;
+} next_multi_entries[] = {
+    {{"0 0 */2 * * * *", "0 0 0 * * * *", "0 30 23 * * * *"}, "2023-08-28_23:30:00", 2},
+    {{"0 0 0 * * * *", "0 0 */2 * * * *", "0 0 0 * * 2 *"}, "2023-08-29_00:00:00", 0},
+    {{"0 0 12 * * 6 *", "0 0 0 1 * * *", "0 0 0 31 12 * *"}, "2023-09-01_00:00:00", 1},
+    {{"0 0 12 * * 6 *", "0 0 6 * * 2 *", "0 0 6 29 8 * *"}, "2023-08-29_06:00:00", 1},
+};
+
+/**
+ * \brief           Check \ref lwdtc_cron_next_multi, including contexts that fire at the same time
+ * \return          `0` on success, `-1` otherwise
+ */
+static int
+prv_check_next_multi(void) {
+    lwdtc_cron_ctx_t ctxs[3];
+    time_t time;
+    size_t index = 0;
+
+    for (size_t i = 0; i < LWDTC_ARRAYSIZE(next_multi_entries); ++i) {
+        const char* time_next;
+
+        lwdtc_cron_parse_multi(ctxs, next_multi_entries[i].cron_strs, LWDTC_ARRAYSIZE(ctxs), NULL);
+        lwdtc_cron_next_multi(ctxs, LWDTC_ARRAYSIZE(ctxs), TIME_T_START, &time, &index);
+        time_next = prv_format_time_to_str(localtime(&time));
+        if (strcmp(time_next, next_multi_entries[i].next_str) != 0 || index != next_multi_entries[i].index) {
+            printf("Next multi failed: entry: %u, exp: %s (%u), got: %s (%u)\r\n", (unsigned)i,
+                   next_multi_entries[i].next_str, (unsigned)next_multi_entries[i].index, time_next, (unsigned)index);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* Set operations on two contexts, expected result strings. Merge is `NULL` when union is not single context */
+static const struct {
+    const char *a, *b;
+    const char* intersect;
+    const char* merge;
+    const char* except[2];
+    uint8_t is_subset;
+} set_entries[] = {
+    {"* * 8-17 * * 1-5 *",
+     "0 */15 * * * * *",
+     "0 */15 8-17 * * 1-5 *",
+     NULL,
+     {"1-59 * 8-17 * * 1-5 *", "0 1-14,16-29,31-44,46-59 8-17 * * 1-5 *"},
+     0},
+    {"0 0 8 * * 1-5 *", "0 0 8 * * 5,6 *", "0 0 8 * * 5 *", "0 0 8 * * 1-6 *", {"0 0 8 * * 1-4 *", NULL}, 0},
+    {"0 0 8 * * 1 *", "0 0 * * * 1-5 *", "0 0 8 * * 1 *", "0 0 * * * 1-5 *", {NULL, NULL}, 1},
+    {"0 0 8-17 * * 1-5 *",
+     "0 0 12-20 * * 1-3 *",
+     "0 0 12-17 * * 1-3 *",
+     NULL,
+     {"0 0 8-11 * * 1-5 *", "0 0 12-17 * * 4-5 *"},
+     0},
+};
+
+/* Arrays of contexts before and after optimization */
+static struct {
+    const char* cron_strs[4];
+    const char* opt_strs[4];
+} optimize_entries[] = {
+    {{"0 0 8 * * 1 *", "0 0 8 * * 2-5 *", "0 0 8 * * 3 *", "0 0 0 1 * * *"}, {"0 0 8 * * 1-5 *", "0 0 0 1 * * *"}},
+    {{"0 0 12 * * * *", "0 0 12 1 * * *", "0 30 12 * * * *", "0 0 12 * 1 * *"}, {"0 0,30 12 * * * *"}},
+};
+
+/**
+ * \brief           Check if context is valid at the same times as cron string
+ * \param[in]       ctx: Cron context
+ * \param[in]       cron_str: Expected cron string
+ * \return          `1` if equal, `0` otherwise
+ */
+static uint8_t
+prv_cron_is_equal(const lwdtc_cron_ctx_t* ctx, const char* cron_str) {
+    lwdtc_cron_ctx_t ctx_exp;
+
+    return lwdtc_cron_parse(&ctx_exp, cron_str) == lwdtcOK && lwdtc_cron_is_subset(ctx, &ctx_exp) == lwdtcOK
+           && lwdtc_cron_is_subset(&ctx_exp, ctx) == lwdtcOK;
+}
+
+/**
+ * \brief           Check \ref lwdtc_cron_intersect, \ref lwdtc_cron_is_subset, \ref lwdtc_cron_merge,
+ *                      \ref lwdtc_cron_except and \ref lwdtc_cron_optimize results
+ * \return          `0` on success, `-1` otherwise
+ */
+static int
+prv_check_set(void) {
+    lwdtc_cron_ctx_t ctxs[4], out[LWDTC_CRON_EXCEPT_MAX];
+    size_t cnt;
+
+    for (size_t i = 0; i < LWDTC_ARRAYSIZE(set_entries); ++i) {
+        const char* op = NULL;
+        size_t except_cnt = 0;
+
+        lwdtc_cron_parse(&ctxs[0], set_entries[i].a);
+        lwdtc_cron_parse(&ctxs[1], set_entries[i].b);
+        while (except_cnt < LWDTC_ARRAYSIZE(set_entries[i].except) && set_entries[i].except[except_cnt] != NULL) {
+            ++except_cnt;
+        }
+        if (lwdtc_cron_intersect(&out[0], ctxs, 2) != lwdtcOK
+            || !prv_cron_is_equal(&out[0], set_entries[i].intersect)) {
+            op = "intersect";
+        } else if ((lwdtc_cron_is_subset(&ctxs[0], &ctxs[1]) == lwdtcOK) != set_entries[i].is_subset) {
+            op = "is_subset";
+        } else if (set_entries[i].merge == NULL ? lwdtc_cron_merge(&out[0], &ctxs[0], &ctxs[1]) != lwdtcERR
+                                                : (lwdtc_cron_merge(&out[0], &ctxs[0], &ctxs[1]) != lwdtcOK
+                                                   || !prv_cron_is_equal(&out[0], set_entries[i].merge))) {
+            op = "merge";
+        } else if (lwdtc_cron_except(out, LWDTC_ARRAYSIZE(out), &cnt, &ctxs[0], &ctxs[1]) != lwdtcOK
+                   || cnt != except_cnt) {
+            op = "except";
+        } else {
+            for (size_t n = 0; n < cnt; ++n) {
+                if (!prv_cron_is_equal(&out[n], set_entries[i].except[n])) {
+                    op = "except";
+                }
+            }
+        }
+        if (op != NULL) {
+            printf("Set failed: op: %s, a: %s, b: %s\r\n", op, set_entries[i].a, set_entries[i].b);
+            return -1;
+        }
+    }
+
+    for (size_t i = 0; i < LWDTC_ARRAYSIZE(optimize_entries); ++i) {
+        lwdtc_cron_parse_multi(ctxs, optimize_entries[i].cron_strs, LWDTC_ARRAYSIZE(ctxs), NULL);
+        lwdtc_cron_optimize(ctxs, LWDTC_ARRAYSIZE(ctxs), &cnt);
+        for (size_t n = 0; n < LWDTC_ARRAYSIZE(optimize_entries[i].opt_strs); ++n) {
+            if ((n < cnt) != (optimize_entries[i].opt_strs[n] != NULL)
+                || (n < cnt && !prv_cron_is_equal(&ctxs[n], optimize_entries[i].opt_strs[n]))) {
+                printf("Optimize failed: entry: %u, new len: %u\r\n", (unsigned)i, (unsigned)cnt);
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+/* Next times of sparse crons, searched with day cache, on dates relative to start time */
+static const struct {
+    const char* cron_str;
+    const char* next_str[3];
+} daycache_entries[] = {
+    {"0 0 12 29 2 * *", {"2024-02-29_12:00:00", "2028-02-29_12:00:00", "2032-02-29_12:00:00"}},
+    {"0 30 6 13 * 5 *", {"2023-10-13_06:30:00", "2024-09-13_06:30:00", "2024-12-13_06:30:00"}},
+    {"0 0 0 31 12 * *", {"2023-12-31_00:00:00", "2024-12-31_00:00:00", "2025-12-31_00:00:00"}},
+    {"0 0 0 1 1 1 *", {"2024-01-01_00:00:00", "2029-01-01_00:00:00", "2035-01-01_00:00:00"}},
+};
+
+/**
+ * \brief           Convert time to UTC, with invalid day in year
+ * \param[out]      tm_time: Output time structure
+ * \param[in]       time: Time to convert
+ * \param[in]       arg: User argument, not used
+ */
+static void
+prv_get_time_bad_yday(struct tm* tm_time, const time_t* time, void* arg) {
+    (void)arg;
+    *tm_time = *gmtime(time);
+    tm_time->tm_yday = 365;
+}
+
+/**
+ * \brief           Check \ref lwdtc_cron_next_with_cache in local time,
+ *                      and in time zone with invalid day in year
+ * \return          `0` on success, `-1` otherwise
+ */
+static int
+prv_check_daycache(void) {
+    static const lwdtc_tz_t tz = {.get_time = prv_get_time_bad_yday};
+    lwdtc_cron_daycache_t cache;
+    lwdtc_cron_ctx_t ctx;
+    time_t time;
+
+    for (size_t run = 0; run < 2; ++run) {
+        for (size_t i = 0; i < LWDTC_ARRAYSIZE(daycache_entries); ++i) {
+            lwdtc_cron_parse(&ctx, daycache_entries[i].cron_str);
+            lwdtc_cron_daycache_reset(&cache);
+            lwdtc_cron_daycache_set_tz(&cache, run == 0 ? NULL : &tz);
+            time = TIME_T_START;
+            for (size_t n = 0; n < LWDTC_ARRAYSIZE(daycache_entries[i].next_str); ++n) {
+                const char* time_next = "none";
+
+                if (lwdtc_cron_next_with_cache(&ctx, &cache, time, &time) == lwdtcOK) {
+                    time_next = prv_format_time_to_str(run == 0 ? localtime(&time) : gmtime(&time));
+                }
+                if (strcmp(time_next, daycache_entries[i].next_str[n]) != 0) {
+                    printf("Day cache failed: cron: %s, zone: %s, exp: %s, got: %s\r\n", daycache_entries[i].cron_str,
+                           run == 0 ? "local" : "utc", daycache_entries[i].next_str[n], time_next);
+                    return -1;
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+/* Hashed values for fixed job keys, expected as cron string with explicit values */
+static const struct {
+    const char* cron_str;
+    const char* key;
+    const char* exp_str;
+} hash_entries[] = {
+    {"H H H H H H *", "backup", "2 18 6 18 12 0 *"},
+    {"H H H H H H *", "report", "40 8 19 17 11 1 *"},
+    {"H H H H H H *", "sync-db", "45 32 6 24 12 2 *"},
+    {"H(10-20) H/15 H(9-17) * * H(1-5) *", "backup", "13 3,18,33,48 12 * * 5 *"},
+    {"H(10-20) H/15 H(9-17) * * H(1-5) *", "report", "20 8,23,38,53 16 * * 5 *"},
+    {"H(10-20) H/15 H(9-17) * * H(1-5) *", "sync-db", "14 2,17,32,47 15 * * 1 *"},
+};
+
+/**
+ * \brief           Check \ref lwdtc_cron_parse_with_key hashed values
+ * \return          `0` on success, `-1` otherwise
+ */
+static int
+prv_check_hash(void) {
+    lwdtc_cron_ctx_t ctx;
+
+    for (size_t i = 0; i < LWDTC_ARRAYSIZE(hash_entries); ++i) {
+        if (lwdtc_cron_parse_with_key(&ctx, hash_entries[i].cron_str, strlen(hash_entries[i].cron_str),
+                                      hash_entries[i].key, strlen(hash_entries[i].key))
+                != lwdtcOK
+            || !prv_cron_is_equal(&ctx, hash_entries[i].exp_str)) {
+            printf("Hash failed: cron: %s, key: %s, exp: %s\r\n", hash_entries[i].cron_str, hash_entries[i].key,
+                   hash_entries[i].exp_str);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* Unsorted local times, as number of days after 2023-08-28 (Monday) and time, used for batch match */
+static const struct {
+    uint32_t day;
+    const char* time_str;
+} match_times[] = {
+    {0, "08:00:00"}, {1, "08:00:00"}, {0, "08:15:30"}, {5, "12:00:00"}, {1, "23:59:59"},
+    {0, "08:00:00"}, {4, "00:00:00"}, {2, "17:45:00"}, {6, "08:00:00"}, {1, "08:00:01"},
+};
+
+/* Expected match bit-map for the times above, bit `i` for time at index `i` */
+static const struct {
+    const char* cron_str;
+    uint16_t bits;
+} match_entries[] = {
+    {"0 0 8 * * * *", 0x0123},     {"* * 8-17 * * 1-5 *", 0x02A7}, {"0 0 0 1 * * *", 0x0040},
+    {"*/30 * * * * 2,6 *", 0x000A}, {"30 15 8 * * * *", 0x0004},
+};
+
+/**
+ * \brief           Check \ref lwdtc_cron_match_timestamps with unsorted local times
+ * \return          `0` on success, `-1` otherwise
+ */
+static int
+prv_check_match(void) {
+    time_t ts[LWDTC_ARRAYSIZE(match_times)];
+    uint8_t bits[(LWDTC_ARRAYSIZE(match_times) + 7) / 8];
+    lwdtc_cron_ctx_t ctx;
+
+    for (size_t i = 0; i < LWDTC_ARRAYSIZE(match_times); ++i) {
+        ts[i] = prv_get_local_time(match_times[i].time_str, match_times[i].day);
+    }
+    for (size_t i = 0; i < LWDTC_ARRAYSIZE(match_entries); ++i) {
+        uint16_t got;
+
+        lwdtc_cron_parse(&ctx, match_entries[i].cron_str);
+        lwdtc_cron_match_timestamps(&ctx, ts, LWDTC_ARRAYSIZE(ts), bits);
+        got = (uint16_t)(bits[0] | ((uint16_t)bits[1] << 8U)) & 0x03FFU;
+        if (got != match_entries[i].bits) {
+            printf("Match failed: cron: %s, exp: 0x%04X, got: 0x%04X\r\n", match_entries[i].cron_str,
+                   (unsigned)match_entries[i].bits, (unsigned)got);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* Exclusion calendar, with days around start time */
+static const char* excl_str = "# Holidays\n"
+                              "2023-08-29\n"
+                              "2023-09-01..2023-09-04 # Long weekend\n"
+                              "2023-12-25\n"
+                              "2024-01-01\n";
+
+/* Next times with exclusion calendar, from start time */
+static const struct {
+    const char* cron_str;
+    const char* next_str[4];
+} excl_entries[] = {
+    {"0 0 9 * * 1-5 *", {"2023-08-30_09:00:00", "2023-08-31_09:00:00", "2023-09-05_09:00:00", "2023-09-06_09:00:00"}},
+    {"0 0 12 1 * * *", {"2023-10-01_12:00:00", "2023-11-01_12:00:00", "2023-12-01_12:00:00", "2024-02-01_12:00:00"}},
+    {"0 0 0 25 12 * *", {"2024-12-25_00:00:00", "2025-12-25_00:00:00", "2026-12-25_00:00:00", "2027-12-25_00:00:00"}},
+};
+
+/* Validity with exclusion calendar at 09:00 local time, number of days after 2023-08-28 (Monday) */
+static const struct {
+    uint32_t day;
+    uint8_t valid;
+} excl_valid_entries[] = {
+    {0, 1}, {1, 0}, {2, 1}, {4, 0}, {7, 0}, {8, 1},
+};
+
+/**
+ * \brief           Check exclusion calendar parser, \ref lwdtc_cron_is_valid_for_time_excl
+ *                      and next time search with calendar in the day cache
+ * \return          `0` on success, `-1` otherwise
+ */
+static int
+prv_check_excl(void) {
+    static const char* excl_bad_str = "2023-08-30\n\n2023-13-01\n";
+    static const char* excl_full_str = "2023-08-30\n2025-01-01\n";
+    lwdtc_excl_year_t years[2];
+    lwdtc_cron_daycache_t cache;
+    lwdtc_cron_ctx_t ctx;
+    lwdtc_excl_t excl;
+    size_t fail_line = 0;
+    time_t time;
+
+    lwdtc_excl_init(&excl, years, LWDTC_ARRAYSIZE(years));
+    if (lwdtc_excl_parse(&excl, excl_bad_str, strlen(excl_bad_str), &fail_line) == lwdtcOK || fail_line != 3
+        || excl.years_num != 0) {
+        printf("Exclusion failed: invalid calendar, fail line: %u\r\n", (unsigned)fail_line);
+        return -1;
+    }
+    if (lwdtc_excl_parse(&excl, excl_str, strlen(excl_str), &fail_line) != lwdtcOK) {
+        printf("Exclusion failed: calendar, fail line: %u\r\n", (unsigned)fail_line);
+        return -1;
+    }
+
+    /* Calendar is not modified by invalid text, or by text with years that do not fit */
+    if (lwdtc_excl_parse(&excl, excl_bad_str, strlen(excl_bad_str), NULL) == lwdtcOK
+        || lwdtc_excl_parse(&excl, excl_full_str, strlen(excl_full_str), &fail_line) != lwdtcERR || fail_line != 2
+        || lwdtc_excl_is_excluded(&excl, 2023, 8, 30) != lwdtcERR || excl.years_num != 2) {
+        printf("Exclusion failed: calendar modified by failed parse\r\n");
+        return -1;
+    }
+
+    lwdtc_cron_parse(&ctx, "0 0 9 * * 1-5 *");
+    for (size_t i = 0; i < LWDTC_ARRAYSIZE(excl_valid_entries); ++i) {
+        time = prv_get_local_time("09:00:00", excl_valid_entries[i].day);
+        if ((lwdtc_cron_is_valid_for_time_excl(localtime(&time), &ctx, &excl) == lwdtcOK)
+            != excl_valid_entries[i].valid) {
+            printf("Exclusion failed: valid, day: %u, exp: %u\r\n", (unsigned)excl_valid_entries[i].day,
+                   (unsigned)excl_valid_entries[i].valid);
+            return -1;
+        }
+    }
+
+    for (size_t i = 0; i < LWDTC_ARRAYSIZE(excl_entries); ++i) {
+        lwdtc_cron_parse(&ctx, excl_entries[i].cron_str);
+        lwdtc_cron_daycache_reset(&cache);
+        lwdtc_cron_daycache_set_excl(&cache, &excl);
+        time = TIME_T_START;
+        for (size_t n = 0; n < LWDTC_ARRAYSIZE(excl_entries[i].next_str); ++n) {
+            const char* time_next = "none";
+
+            if (lwdtc_cron_next_with_cache(&ctx, &cache, time, &time) == lwdtcOK) {
+                time_next = prv_format_time_to_str(localtime(&time));
+            }
+            if (strcmp(time_next, excl_entries[i].next_str[n]) != 0) {
+                printf("Exclusion failed: cron: %s, exp: %s, got: %s\r\n", excl_entries[i].cron_str,
+                       excl_entries[i].next_str[n], time_next);
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+/* Zones of the table, including two different objects with the same offset */
+static const lwdtc_tz_t tz_table_zones[] = {
+    {.utc_offset = 20700}, {.utc_offset = 0}, {.utc_offset = -18000}, {.utc_offset = 20700},
+    {.get_time = prv_get_time_bad_yday, .id = 1},
+};
+
+/* Table entries, with index of their zone */
+static const struct {
+    const char* cron_str;
+    size_t tz_index;
+} tz_table_entries[] = {
+    {"0 0 9 * * * *", 0}, {"0 0 9 * * * *", 1}, {"0 0 9 * * * *", 2},
+    {"0 15 3 * * * *", 1}, {"0 0 22 * * * *", 3}, {"0 30 7 * * * *", 4},
+};
+
+/* Next times in UTC from start time, with fired index and match bit-map, before and after the sort */
+static const struct {
+    const char* next_str;
+    size_t index[2];
+    uint8_t bits[2];
+} tz_table_next_entries[] = {
+    {"2023-08-29_03:15:00", {0, 2}, {0x09, 0x0C}}, {"2023-08-29_07:30:00", {5, 5}, {0x20, 0x20}},
+    {"2023-08-29_09:00:00", {1, 1}, {0x02, 0x02}}, {"2023-08-29_14:00:00", {2, 0}, {0x04, 0x01}},
+    {"2023-08-29_16:15:00", {4, 4}, {0x10, 0x10}}, {"2023-08-30_03:15:00", {0, 2}, {0x09, 0x0C}},
+};
+
+/**
+ * \brief           Check \ref lwdtc_cron_tz_table_next and \ref lwdtc_cron_tz_table_match
+ *                      with multiple zones, before and after \ref lwdtc_cron_tz_table_sort
+ * \return          `0` on success, `-1` otherwise
+ */
+static int
+prv_check_tz_table(void) {
+    lwdtc_cron_tz_entry_t entries[LWDTC_ARRAYSIZE(tz_table_entries)];
+    uint8_t bits;
+    size_t index = 0;
+    time_t time;
+
+    for (size_t i = 0; i < LWDTC_ARRAYSIZE(entries); ++i) {
+        lwdtc_cron_parse(&entries[i].ctx, tz_table_entries[i].cron_str);
+        entries[i].tz = &tz_table_zones[tz_table_entries[i].tz_index];
+    }
+    for (size_t run = 0; run < 2; ++run) {
+        if (run == 1 && lwdtc_cron_tz_table_sort(entries, LWDTC_ARRAYSIZE(entries)) != lwdtcOK) {
+            printf("Time zone table failed: sort\r\n");
+            return -1;
+        }
+        time = TIME_T_START;
+        for (size_t n = 0; n < LWDTC_ARRAYSIZE(tz_table_next_entries); ++n) {
+            const char* time_next = "none";
+
+            bits = 0;
+            if (lwdtc_cron_tz_table_next(entries, LWDTC_ARRAYSIZE(entries), time, &time, &index) == lwdtcOK) {
+                time_next = prv_format_time_to_str(gmtime(&time));
+                lwdtc_cron_tz_table_match(entries, LWDTC_ARRAYSIZE(entries), time, &bits);
+            }
+            if (strcmp(time_next, tz_table_next_entries[n].next_str) != 0
+                || index != tz_table_next_entries[n].index[run] || bits != tz_table_next_entries[n].bits[run]) {
+                printf("Time zone table failed: sorted: %u, exp: %s (%u, 0x%02X), got: %s (%u, 0x%02X)\r\n",
+                       (unsigned)run, tz_table_next_entries[n].next_str, (unsigned)tz_table_next_entries[n].index[run],
+                       (unsigned)tz_table_next_entries[n].bits[run], time_next, (unsigned)index, (unsigned)bits);
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+#if LWDTC_CFG_DAY_SPECIAL
+/* Special day operators, next times from start time */
+static const struct {
+    const char* cron_str;
+    const char* next_str[3];
+} day_special_entries[] = {
+    {"0 0 18 LW * * *", {"2023-08-31_18:00:00", "2023-09-29_18:00:00", "2023-10-31_18:00:00"}},
+    {"0 0 0 L-2 * * *", {"2023-08-29_00:00:00", "2023-09-28_00:00:00", "2023-10-29_00:00:00"}},
+    {"0 0 6 1,L * * *", {"2023-08-31_06:00:00", "2023-09-01_06:00:00", "2023-09-30_06:00:00"}},
+    {"0 0 8 15W * * *", {"2023-09-15_08:00:00", "2023-10-16_08:00:00", "2023-11-15_08:00:00"}},
+    {"0 0 9 1W 6 * *", {"2024-06-03_09:00:00", "2025-06-02_09:00:00", "2026-06-01_09:00:00"}},
+    {"0 0 10 * * 2#2 *", {"2023-09-12_10:00:00", "2023-10-10_10:00:00", "2023-11-14_10:00:00"}},
+    {"0 0 12 * * 5L *", {"2023-09-29_12:00:00", "2023-10-27_12:00:00", "2023-11-24_12:00:00"}},
+};
+
+/**
+ * \brief           Check next times of crons with `L`, `W` and `#` operators
+ * \return          `0` on success, `-1` otherwise
+ */
+static int
+prv_check_day_special(void) {
+    lwdtc_cron_ctx_t ctx;
+    time_t time;
+
+    for (size_t i = 0; i < LWDTC_ARRAYSIZE(day_special_entries); ++i) {
+        if (lwdtc_cron_parse(&ctx, day_special_entries[i].cron_str) != lwdtcOK) {
+            printf("Special day failed: cron: %s, parse\r\n", day_special_entries[i].cron_str);
+            return -1;
+        }
+        time = TIME_T_START;
+        for (size_t n = 0; n < LWDTC_ARRAYSIZE(day_special_entries[i].next_str); ++n) {
+            const char* time_next = "none";
+
+            if (lwdtc_cron_next(&ctx, time, &time) == lwdtcOK) {
+                time_next = prv_format_time_to_str(localtime(&time));
+            }
+            if (strcmp(time_next, day_special_entries[i].next_str[n]) != 0) {
+                printf("Special day failed: cron: %s, exp: %s, got: %s\r\n", day_special_entries[i].cron_str,
+                       day_special_entries[i].next_str[n], time_next);
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+#endif /* LWDTC_CFG_DAY_SPECIAL */
+
+/* Next date and time from 2023-08-28 23:09:50 (Monday), as year, month, day, hours, minutes, seconds and week day */
+static const struct {
+    const char* cron_str;
+    uint32_t next[7];
+} packed_entries[] = {
+    {"*/10 * * * * * *", {2023, 8, 28, 23, 10, 0, 1}}, {"0 0 0 * * 5 *", {2023, 9, 1, 0, 0, 0, 5}},
+    {"0 30 9 1 * * *", {2023, 9, 1, 9, 30, 0, 5}},     {"0 0 0 * * 0 *", {2023, 9, 3, 0, 0, 0, 0}},
+    {"0 0 0 1 1 * *", {2024, 1, 1, 0, 0, 0, 1}},       {"0 0 12 29 2 * *", {2024, 2, 29, 12, 0, 0, 4}},
+};
+
+/**
+ * \brief           Convert value to BCD format
+ * \param[in]       val: Value to convert, `0` to `99`
+ * \return          BCD value
+ */
+static uint8_t
+prv_to_bcd(uint32_t val) {
+    return (uint8_t)(((val / 10U) << 4U) | (val % 10U));
+}
+
+/**
+ * \brief           Convert date and time to RTC registers in BCD format
+ * \param[out]      bcd: Output registers
+ * \param[in]       dt: Year, month, day, hours, minutes, seconds and week day
+ */
+static void
+prv_to_bcd_regs(lwdtc_bcd_t* bcd, const uint32_t* dt) {
+    bcd->year = prv_to_bcd(dt[0] - 2000U);
+    bcd->mon = prv_to_bcd(dt[1]);
+    bcd->mday = prv_to_bcd(dt[2]);
+    bcd->hour = prv_to_bcd(dt[3]);
+    bcd->min = prv_to_bcd(dt[4]);
+    bcd->sec = prv_to_bcd(dt[5]);
+    bcd->wday = dt[6] == 0 ? 7 : (uint8_t)dt[6];
+}
+
+/**
+ * \brief           Check next time and validity of packed \ref lwdtc_dt32_t, \ref lwdtc_dt64_t
+ *                      and \ref lwdtc_bcd_t values
+ * \return          `0` on success, `-1` otherwise
+ */
+static int
+prv_check_packed(void) {
+    static const uint32_t start[7] = {2023, 8, 28, 23, 9, 50, 1};
+    lwdtc_dt32_t dt32, dt32_exp;
+    lwdtc_dt64_t dt64, dt64_exp;
+    lwdtc_bcd_t bcd, bcd_exp, bcd_start;
+    lwdtc_cron_ctx_t ctx;
+
+    prv_to_bcd_regs(&bcd_start, start);
+    for (size_t i = 0; i < LWDTC_ARRAYSIZE(packed_entries); ++i) {
+        const uint32_t* n = packed_entries[i].next;
+        const char* type = NULL;
+
+        lwdtc_cron_parse(&ctx, packed_entries[i].cron_str);
+        dt32_exp = LWDTC_DT32(n[0], n[1], n[2], n[3], n[4], n[5]);
+        dt64_exp = LWDTC_DT64(n[0], n[1], n[2], n[3], n[4], n[5], n[6]);
+        prv_to_bcd_regs(&bcd_exp, n);
+        if (lwdtc_cron_next_dt32(&ctx, LWDTC_DT32(2023, 8, 28, 23, 9, 50), &dt32) != lwdtcOK || dt32 != dt32_exp
+            || lwdtc_cron_is_valid_for_dt32(dt32, &ctx) != lwdtcOK) {
+            type = "dt32";
+        } else if (lwdtc_cron_next_dt64(&ctx, LWDTC_DT64(2023, 8, 28, 23, 9, 50, 1), &dt64) != lwdtcOK
+                   || dt64 != dt64_exp || lwdtc_cron_is_valid_for_dt64(dt64, &ctx) != lwdtcOK) {
+            type = "dt64";
+        } else if (lwdtc_cron_next_bcd(&ctx, &bcd_start, &bcd) != lwdtcOK
+                   || memcmp(&bcd, &bcd_exp, sizeof(bcd)) != 0 || lwdtc_cron_is_valid_for_bcd(&bcd, &ctx) != lwdtcOK) {
+            type = "bcd";
+        }
+        if (type != NULL) {
+            printf("Packed failed: cron: %s, type: %s\r\n", packed_entries[i].cron_str, type);
+            return -1;
+        }
+    }
+    return 0;
+}
+
 int
 main(void) {
     lwdtc_cron_ctx_t cron_ctx = {0};
@@ -160,6 +953,36 @@ main(void) {
     uint64_t time_end = GetTickCount64();
     printf("Total tick: %llu\r\n\r\n", (unsigned long long)(time_end - time_start));
 
+    prv_bench_match();
+    prv_bench_shapes();
+    if (prv_check_fired_between() != 0) {
+        return -1;
+    }
+    if (prv_check_count() != 0 || prv_check_tz() != 0 || prv_check_tz_table() != 0) {
+        return -1;
+    }
+    if (prv_check_next_multi() != 0 || prv_check_set() != 0 || prv_check_daycache() != 0) {
+        return -1;
+    }
+    if (prv_check_hash() != 0 || prv_check_match() != 0 || prv_check_excl() != 0) {
+        return -1;
+    }
+    if (prv_check_packed() != 0) {
+        return -1;
+    }
+#if LWDTC_CFG_DAY_SPECIAL
+    if (prv_check_day_special() != 0) {
+        return -1;
+    }
+#endif /* LWDTC_CFG_DAY_SPECIAL */
+
+    /* Repeat local time checks in zone with offset, that is not multiple of half an hour */
+    _putenv("TZ=NPT-05:45");
+    _tzset();
+    if (prv_check_fired_between() != 0 || prv_check_count() != 0 || prv_check_match() != 0) {
+        return -1;
+    }
+
     return 0;
 
     while (1) {
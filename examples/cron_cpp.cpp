@@ -0,0 +1,32 @@
+#include <chrono>
+#include <cstdio>
+#include <ranges>
+#include "lwdtc/lwdtc.hpp"
+
+int
+cron_cpp() {
+    using namespace std::chrono;
+
+    /* Parse cron, to be valid every 15 minutes */
+    auto cron = lwdtc::cron::parse("0 */15 * * * * *");
+    if (!cron) {
+        std::printf("Error parsing CRON...\r\n");
+        return -1;
+    }
+
+    /* Print next 10 fire times */
+    auto now = floor<seconds>(system_clock::now());
+    for (sys_seconds time : cron->times(now) | std::views::take(10)) {
+        std::printf("Next fire: %lld\r\n", (long long)time.time_since_epoch().count());
+    }
+
+    /* Count fire times until the end of the day */
+    auto deadline = now + hours{24};
+    size_t count = 0;
+    for ([[maybe_unused]] sys_seconds time :
+         cron->times(now) | std::views::take_while([&](sys_seconds t) { return t < deadline; })) {
+        ++count;
+    }
+    std::printf("Fires in next 24 hours: %u\r\n", (unsigned)count);
+    return 0;
+}
@@ -0,0 +1,45 @@
+#include "windows.h"
+#include <time.h>
+#include <stdio.h>
+#include <string.h>
+#include "lwdtc/lwdtc_excl.h"
+
+/*
+ * This is example for docs user manual
+ *
+ * Runs every weekday at 09:00, except public holidays.
+ * Calendar is a string here, but is typically read from the file
+ */
+static const char* holidays = "# Public holidays\n"
+                              "2025-01-01\n"
+                              "2025-04-21 # Easter Monday\n"
+                              "2025-12-24..2025-12-26\n";
+static lwdtc_cron_ctx_t cron_ctx;
+static lwdtc_cron_daycache_t cache;
+static lwdtc_excl_year_t excl_years[4];
+static lwdtc_excl_t excl;
+
+int
+cron_excl(void) {
+    time_t rawtime, next;
+    size_t fail_line;
+
+    /* Parse cron and calendar */
+    lwdtc_excl_init(&excl, excl_years, LWDTC_ARRAYSIZE(excl_years));
+    if (lwdtc_cron_parse(&cron_ctx, "0 0 9 * * 1-5 *") != lwdtcOK
+        || lwdtc_excl_parse(&excl, holidays, strlen(holidays), &fail_line) != lwdtcOK) {
+        printf("Could not parse CRON or calendar\r\n");
+        while (1) {}
+    }
+
+    /* Attach calendar to the day cache, excluded days are skipped by the search */
+    lwdtc_cron_daycache_reset(&cache);
+    lwdtc_cron_daycache_set_excl(&cache, &excl);
+
+    time(&rawtime);
+    for (size_t i = 0; i < 5 && lwdtc_cron_next_with_cache(&cron_ctx, &cache, rawtime, &next) == lwdtcOK; ++i) {
+        printf("Next run: %s", ctime(&next));
+        rawtime = next;
+    }
+    return 0;
+}
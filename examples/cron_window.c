@@ -0,0 +1,43 @@
+#include "windows.h"
+#include <time.h>
+#include <stdio.h>
+#include "lwdtc/lwdtc_window.h"
+
+/*
+ * This is example for docs user manual
+ *
+ * Defines time window:
+ * - Opens on Monday at 07:00 morning
+ * - Closes on Friday at 19:30 evening
+ */
+static lwdtc_cron_ctx_t cron_open, cron_close;
+static lwdtc_window_t window;
+
+int
+cron_window(void) {
+    time_t rawtime, edge;
+
+    /* Parse both edges of the window */
+    if (lwdtc_cron_parse(&cron_open, "0 0 7 * * 1 *") != lwdtcOK
+        || lwdtc_cron_parse(&cron_close, "0 30 19 * * 5 *") != lwdtcOK) {
+        printf("Could not parse CRON\r\n");
+        while (1) {}
+    }
+    lwdtc_window_init(&window, &cron_open, &cron_close);
+
+    while (1) {
+        time(&rawtime);
+
+        /* Check state and get the time of next open or close */
+        printf("Window is %s\r\n", lwdtc_window_is_active(&window, rawtime) ? "open" : "closed");
+        if (lwdtc_window_next_edge(&window, rawtime, &edge) != lwdtcOK) {
+            printf("Window state does not change anymore\r\n");
+            break;
+        }
+
+        /* Sleep until next edge, instead of polling. Sleep from windows.h lib */
+        printf("Next change in %u seconds\r\n", (unsigned)(edge - rawtime));
+        Sleep((DWORD)(edge - rawtime) * 1000);
+    }
+    return 0;
+}
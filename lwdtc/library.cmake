@@ -17,6 +17,13 @@ set(LWDTC_CUSTOM_INC_DIR ${CMAKE_CURRENT_BINARY_DIR}/lib_inc)
 # Library core sources
 set(lwdtc_core_SRCS 
     ${CMAKE_CURRENT_LIST_DIR}/src/lwdtc/lwdtc.c
+    ${CMAKE_CURRENT_LIST_DIR}/src/lwdtc/lwdtc_agenda.c
+    ${CMAKE_CURRENT_LIST_DIR}/src/lwdtc/lwdtc_excl.c
+    ${CMAKE_CURRENT_LIST_DIR}/src/lwdtc/lwdtc_journal.c
+    ${CMAKE_CURRENT_LIST_DIR}/src/lwdtc/lwdtc_reload.c
+    ${CMAKE_CURRENT_LIST_DIR}/src/lwdtc/lwdtc_rtc.c
+    ${CMAKE_CURRENT_LIST_DIR}/src/lwdtc/lwdtc_table.c
+    ${CMAKE_CURRENT_LIST_DIR}/src/lwdtc/lwdtc_window.c
 )
 
 # Setup include directories
@@ -66,6 +66,19 @@ extern "C" {
 #define LWDTC_YEAR_MIN     0   /*!< Minimum value for year field */
 #define LWDTC_YEAR_MAX     100 /*!< Maximum value for year field */
 
+#if LWDTC_CFG_DAY_SPECIAL || __DOXYGEN__
+#define LWDTC_MDAY_MAP_SIZE 12 /*!< Size of day in month bit-map in bytes */
+#define LWDTC_WDAY_MAP_SIZE 7  /*!< Size of week day bit-map in bytes */
+#else
+#define LWDTC_MDAY_MAP_SIZE 4
+#define LWDTC_WDAY_MAP_SIZE 1
+#endif /* LWDTC_CFG_DAY_SPECIAL || __DOXYGEN__ */
+
+/**
+ * \brief           Maximum number of contexts generated by \ref lwdtc_cron_except function
+ */
+#define LWDTC_CRON_EXCEPT_MAX 7
+
 /**
  * \brief           Calculate size of statically allocated array
  * \param[in]       x: Array
@@ -91,25 +104,208 @@ typedef enum {
  */
 typedef struct {
     uint32_t flags;   /*!< List of all sort of flags for internal use */
-    uint8_t sec[8];   /*!< Seconds field. Must support bits from 0 to 59 */
+#if LWDTC_CFG_FIELD_SEC || __DOXYGEN__
+    uint8_t sec[8]; /*!< Seconds field. Must support bits from 0 to 59 */
+#endif              /* LWDTC_CFG_FIELD_SEC || __DOXYGEN__ */
     uint8_t min[8];   /*!< Minutes field. Must support bits from 0 to 59 */
     uint8_t hour[3];  /*!< Hours field. Must support bits from 0 to 23 */
-    uint8_t mday[4];  /*!< Day number in a month. Must support bits from 0 to 30 */
-    uint8_t mon[2];   /*!< Month field. Must support bits from 0 to 11 */
-    uint8_t wday[1];  /*!< Week day. Must support bits from 0 (Sunday) to 6 (Saturday) */
+    uint8_t mday[LWDTC_MDAY_MAP_SIZE]; /*!< Day number in a month. Must support bits from 0 to 30,
+                                            followed by special operators when enabled */
+    uint8_t mon[2];                    /*!< Month field. Must support bits from 0 to 11 */
+    uint8_t wday[LWDTC_WDAY_MAP_SIZE]; /*!< Week day. Must support bits from 0 (Sunday) to 6 (Saturday),
+                                            followed by special operators when enabled */
+#if LWDTC_CFG_FIELD_YEAR || __DOXYGEN__
     uint8_t year[13]; /*!< Year from 0 - 100, indicating 2000 - 2100. Must support bits 0 to 100 */
+#endif                /* LWDTC_CFG_FIELD_YEAR || __DOXYGEN__ */
 } lwdtc_cron_ctx_t;
 
+/**
+ * \brief           Excluded days of one year, such as public holidays
+ */
+typedef struct {
+    int32_t year;      /*!< Full year number */
+    uint32_t days[12]; /*!< Bit-map of excluded days. Bit `0` is January 1st, up to `365` bits */
+} lwdtc_excl_year_t;
+
+/**
+ * \brief           Exclusion calendar, with bit-map of excluded days for each year
+ * 
+ * Memory for the years is provided by the application.
+ * Use functions from \ref LWDTC_EXCL module to build it
+ */
+typedef struct {
+    lwdtc_excl_year_t* years; /*!< Array of years, sorted by year number */
+    size_t years_len;         /*!< Length of the array */
+    size_t years_num;         /*!< Number of used entries in the array */
+} lwdtc_excl_t;
+
+/**
+ * \brief           Time zone, used instead of \ref LWDTC_CFG_GET_LOCALTIME for specific contexts
+ * 
+ * Zone is either fixed offset from UTC, converted with arithmetic only,
+ * or user function, that may apply daylight saving time rules of the zone.
+ * Both are independent from the process-wide local time settings.
+ */
+typedef struct {
+    int32_t utc_offset; /*!< Offset from UTC in units of seconds, positive east of Greenwich.
+                                Must be multiple of a minute, less than a day. Used when `get_time` is `NULL` */
+    void (*get_time)(struct tm* tm_time, const time_t* time,
+                     void* arg); /*!< Optional function to convert time to local time of the zone */
+    void* arg;                   /*!< User argument for `get_time` function */
+    uint32_t id; /*!< Zone identifier, used to order zones with `get_time` function in the table.
+                                Zones with the same function and argument should use the same identifier */
+} lwdtc_tz_t;
+
+/**
+ * \brief           Table entry, context bound to its time zone
+ */
+typedef struct {
+    lwdtc_cron_ctx_t ctx;  /*!< Cron context */
+    const lwdtc_tz_t* tz; /*!< Time zone of the context. `NULL` for \ref LWDTC_CFG_GET_LOCALTIME */
+} lwdtc_cron_tz_entry_t;
+
+/**
+ * \brief           Day cache with bit-map of days in a year, when cron may be valid
+ * 
+ * It is built from day-level fields (day in month, month, week day and year)
+ * and allows next time search to skip non-eligible days at once.
+ */
+typedef struct {
+    const lwdtc_cron_ctx_t* ctx; /*!< Context the cache has been built for. `NULL` when cache is not built */
+    int32_t year;                /*!< Full year number the cache has been built for */
+    uint32_t days[12];           /*!< Bit-map of eligible days. Bit `0` is January 1st, up to `365` bits */
+    const lwdtc_excl_t* excl;    /*!< Exclusion calendar, its days are never eligible. `NULL` when not used */
+    const lwdtc_tz_t* tz;        /*!< Time zone for the search. `NULL` for \ref LWDTC_CFG_GET_LOCALTIME */
+} lwdtc_cron_daycache_t;
+
+/**
+ * \brief           Memoized result of next time search, dedicated to one context
+ * 
+ * It stores last query and result pair. There is no fire time between them,
+ * hence any query in that interval is answered without the search.
+ */
+typedef struct {
+    const lwdtc_cron_ctx_t* ctx; /*!< Context the memo is valid for. `NULL` when memo is empty */
+    time_t query;                /*!< Last query time */
+    time_t result;               /*!< Next fire time for the last query */
+    lwdtcr_t res;                /*!< Result of the last search */
+    lwdtc_cron_daycache_t cache; /*!< Day cache, kept between the searches */
+} lwdtc_cron_memo_t;
+
+/**
+ * \brief           Packed 32-bit date and time, in FAT file system format
+ * 
+ * Bits `31-25` are year offset from `1980`, bits `24-21` month, `1` to `12`, bits `20-16` day in month,
+ * bits `15-11` hours, bits `10-5` minutes and bits `4-0` seconds divided by `2`.
+ * Value has 2 seconds resolution and stands for 2 seconds interval, starting at even second.
+ * Values compare in time order. Use \ref LWDTC_DT32 to pack the value
+ */
+typedef uint32_t lwdtc_dt32_t;
+
+/**
+ * \brief           Packed 64-bit date and time, one field per byte
+ * 
+ * Bits `63-48` are full year number, bits `47-40` month, `1` to `12`, bits `39-32` day in month,
+ * bits `31-24` hours, bits `23-16` minutes, bits `15-8` seconds
+ * and bits `7-0` week day, `0` (Sunday) to `6` (Saturday).
+ * Values compare in time order. Use \ref LWDTC_DT64 to pack the value
+ */
+typedef uint64_t lwdtc_dt64_t;
+
+/**
+ * \brief           Packed date and time, as BCD registers of typical RTC
+ * 
+ * Members are in order of registers, as in DS1307 and DS3231 devices,
+ * and are read from the device with single burst read.
+ * Hours are in 24-hour format. Week day is `1` (Monday) to `7` (Sunday), value `0` is accepted as Sunday.
+ * Control bits, such as clock halt bit in seconds or century bit in month register, are ignored
+ */
+typedef struct {
+    uint8_t sec;  /*!< Seconds, `0x00` to `0x59` */
+    uint8_t min;  /*!< Minutes, `0x00` to `0x59` */
+    uint8_t hour; /*!< Hours, `0x00` to `0x23` */
+    uint8_t wday; /*!< Week day, `0x01` (Monday) to `0x07` (Sunday) */
+    uint8_t mday; /*!< Day in month, `0x01` to `0x31` */
+    uint8_t mon;  /*!< Month, `0x01` to `0x12` */
+    uint8_t year; /*!< Year offset from year `2000`, `0x00` to `0x99` */
+} lwdtc_bcd_t;
+
+/**
+ * \brief           Pack date and time to \ref lwdtc_dt32_t value
+ * \param[in]       year: Full year number, `1980` to `2107`
+ * \param[in]       mon: Month, `1` to `12`
+ * \param[in]       mday: Day in month, `1` to `31`
+ * \param[in]       hour: Hours, `0` to `23`
+ * \param[in]       min: Minutes, `0` to `59`
+ * \param[in]       sec: Seconds, `0` to `59`, rounded down to even second
+ */
+#define LWDTC_DT32(year, mon, mday, hour, min, sec)                                                                   \
+    ((lwdtc_dt32_t)((((uint32_t)(year) - 1980U) << 25U) | ((uint32_t)(mon) << 21U) | ((uint32_t)(mday) << 16U)         \
+                    | ((uint32_t)(hour) << 11U) | ((uint32_t)(min) << 5U) | ((uint32_t)(sec) >> 1U)))
+
+/**
+ * \brief           Pack date and time to \ref lwdtc_dt64_t value
+ * \param[in]       year: Full year number, `0` to `65535`
+ * \param[in]       mon: Month, `1` to `12`
+ * \param[in]       mday: Day in month, `1` to `31`
+ * \param[in]       hour: Hours, `0` to `23`
+ * \param[in]       min: Minutes, `0` to `59`
+ * \param[in]       sec: Seconds, `0` to `59`
+ * \param[in]       wday: Week day of the date, `0` (Sunday) to `6` (Saturday)
+ */
+#define LWDTC_DT64(year, mon, mday, hour, min, sec, wday)                                                             \
+    ((lwdtc_dt64_t)(((uint64_t)(year) << 48U) | ((uint64_t)(mon) << 40U) | ((uint64_t)(mday) << 32U)                   \
+                    | ((uint64_t)(hour) << 24U) | ((uint64_t)(min) << 16U) | ((uint64_t)(sec) << 8U)                  \
+                    | (uint64_t)(wday)))
+
 lwdtcr_t lwdtc_cron_parse_with_len(lwdtc_cron_ctx_t* ctx, const char* cron_str, size_t cron_str_len);
 lwdtcr_t lwdtc_cron_parse(lwdtc_cron_ctx_t* ctx, const char* cron_str);
+lwdtcr_t lwdtc_cron_parse_with_key(lwdtc_cron_ctx_t* ctx, const char* cron_str, size_t cron_str_len, const char* key,
+                                   size_t key_len);
 lwdtcr_t lwdtc_cron_parse_multi(lwdtc_cron_ctx_t* cron_ctx, const char** cron_strs, size_t ctx_len, size_t* fail_index);
+lwdtcr_t lwdtc_cron_prepare(lwdtc_cron_ctx_t* ctx);
 
 lwdtcr_t lwdtc_cron_is_valid_for_time(const struct tm* tm_time, const lwdtc_cron_ctx_t* cron_ctx);
 lwdtcr_t lwdtc_cron_is_valid_for_time_multi_or(const struct tm* tm_time, const lwdtc_cron_ctx_t* cron_ctx,
                                                size_t ctx_len);
 lwdtcr_t lwdtc_cron_is_valid_for_time_multi_and(const struct tm* tm_time, const lwdtc_cron_ctx_t* cron_ctx,
                                                 size_t ctx_len);
+lwdtcr_t lwdtc_cron_is_valid_for_time_excl(const struct tm* tm_time, const lwdtc_cron_ctx_t* cron_ctx,
+                                           const lwdtc_excl_t* excl);
+lwdtcr_t lwdtc_cron_is_valid_for_dt32(lwdtc_dt32_t dt, const lwdtc_cron_ctx_t* cron_ctx);
+lwdtcr_t lwdtc_cron_is_valid_for_dt64(lwdtc_dt64_t dt, const lwdtc_cron_ctx_t* cron_ctx);
+lwdtcr_t lwdtc_cron_is_valid_for_bcd(const lwdtc_bcd_t* bcd, const lwdtc_cron_ctx_t* cron_ctx);
+lwdtcr_t lwdtc_cron_match_timestamps(const lwdtc_cron_ctx_t* cron_ctx, const time_t* ts, size_t n, uint8_t* out_bits);
 lwdtcr_t lwdtc_cron_next(const lwdtc_cron_ctx_t* cron_ctx, time_t curr_time, time_t* new_time);
+lwdtcr_t lwdtc_cron_next_with_cache(const lwdtc_cron_ctx_t* cron_ctx, lwdtc_cron_daycache_t* cache, time_t curr_time,
+                                    time_t* new_time);
+lwdtcr_t lwdtc_cron_next_dt32(const lwdtc_cron_ctx_t* cron_ctx, lwdtc_dt32_t curr_dt, lwdtc_dt32_t* new_dt);
+lwdtcr_t lwdtc_cron_next_dt64(const lwdtc_cron_ctx_t* cron_ctx, lwdtc_dt64_t curr_dt, lwdtc_dt64_t* new_dt);
+lwdtcr_t lwdtc_cron_next_bcd(const lwdtc_cron_ctx_t* cron_ctx, const lwdtc_bcd_t* curr_bcd, lwdtc_bcd_t* new_bcd);
+lwdtcr_t lwdtc_cron_daycache_reset(lwdtc_cron_daycache_t* cache);
+lwdtcr_t lwdtc_cron_daycache_set_excl(lwdtc_cron_daycache_t* cache, const lwdtc_excl_t* excl);
+lwdtcr_t lwdtc_cron_daycache_set_tz(lwdtc_cron_daycache_t* cache, const lwdtc_tz_t* tz);
+lwdtcr_t lwdtc_cron_next_memo(const lwdtc_cron_ctx_t* cron_ctx, lwdtc_cron_memo_t* memo, time_t curr_time,
+                              time_t* new_time);
+lwdtcr_t lwdtc_cron_memo_reset(lwdtc_cron_memo_t* memo);
+lwdtcr_t lwdtc_cron_count(const lwdtc_cron_ctx_t* cron_ctx, time_t t_from, time_t t_to, size_t* count);
+lwdtcr_t lwdtc_cron_fired_between(const lwdtc_cron_ctx_t* cron_ctx, time_t t_from, time_t t_to, time_t* first_hit);
+lwdtcr_t lwdtc_cron_next_multi(const lwdtc_cron_ctx_t* cron_ctx, size_t ctx_len, time_t curr_time, time_t* new_time,
+                               size_t* ctx_index);
+
+lwdtcr_t lwdtc_tz_get_time(const lwdtc_tz_t* tz, time_t time, struct tm* tm_time);
+lwdtcr_t lwdtc_cron_tz_table_sort(lwdtc_cron_tz_entry_t* entries, size_t entries_len);
+lwdtcr_t lwdtc_cron_tz_table_match(const lwdtc_cron_tz_entry_t* entries, size_t entries_len, time_t time,
+                                   uint8_t* out_bits);
+lwdtcr_t lwdtc_cron_tz_table_next(const lwdtc_cron_tz_entry_t* entries, size_t entries_len, time_t curr_time,
+                                  time_t* new_time, size_t* entry_index);
+
+lwdtcr_t lwdtc_cron_intersect(lwdtc_cron_ctx_t* out_ctx, const lwdtc_cron_ctx_t* cron_ctx, size_t ctx_len);
+lwdtcr_t lwdtc_cron_is_subset(const lwdtc_cron_ctx_t* ctx_a, const lwdtc_cron_ctx_t* ctx_b);
+lwdtcr_t lwdtc_cron_merge(lwdtc_cron_ctx_t* out_ctx, const lwdtc_cron_ctx_t* ctx_a, const lwdtc_cron_ctx_t* ctx_b);
+lwdtcr_t lwdtc_cron_except(lwdtc_cron_ctx_t* out_ctx, size_t out_ctx_len, size_t* out_cnt, const lwdtc_cron_ctx_t* ctx_a,
+                           const lwdtc_cron_ctx_t* ctx_b);
+lwdtcr_t lwdtc_cron_optimize(lwdtc_cron_ctx_t* cron_ctx, size_t ctx_len, size_t* new_len);
 
 /**
  * \}
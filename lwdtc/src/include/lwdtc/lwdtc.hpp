@@ -0,0 +1,254 @@
+/**
+ * \file            lwdtc.hpp
+ * \brief           LwDTC C++20 wrapper
+ */
+
+/*
+ * Copyright (c) 2024 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwDTC - Lightweight Date, Time & Cron library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v1.0.0
+ */
+#ifndef LWDTC_HDR_HPP
+#define LWDTC_HDR_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <ranges>
+#include <string_view>
+#include "lwdtc/lwdtc.h"
+
+/**
+ * \defgroup        LWDTC_CPP C++ wrapper
+ * \brief           Header-only C++20 wrapper with lazy range of fire times
+ * \{
+ */
+
+namespace lwdtc {
+
+/**
+ * \brief           Cron value type, wrapping \ref lwdtc_cron_ctx_t
+ */
+class cron {
+  public:
+    class times_view;
+
+    /**
+     * \brief           Parse cron from string
+     * \param[in]       str: Cron string. Does not need to be `NULL` terminated
+     * \return          Cron object on success, `std::nullopt` if string is invalid
+     */
+    static std::optional<cron>
+    parse(std::string_view str) noexcept {
+        cron c;
+
+        if (lwdtc_cron_parse_with_len(&c.ctx_, str.data(), str.size()) != lwdtcOK) {
+            return std::nullopt;
+        }
+        return c;
+    }
+
+    /**
+     * \brief           Parse cron with hashed values from string
+     * \param[in]       str: Cron string. Does not need to be `NULL` terminated
+     * \param[in]       key: Job key, used to resolve hashed `H` values
+     * \return          Cron object on success, `std::nullopt` if string is invalid
+     */
+    static std::optional<cron>
+    parse(std::string_view str, std::string_view key) noexcept {
+        cron c;
+
+        if (lwdtc_cron_parse_with_key(&c.ctx_, str.data(), str.size(), key.data(), key.size()) != lwdtcOK) {
+            return std::nullopt;
+        }
+        return c;
+    }
+
+    /**
+     * \brief           Check if cron is valid for specific time
+     * \param[in]       time: Time to check
+     * \return          `true` if cron is valid, `false` otherwise
+     */
+    bool
+    matches(std::chrono::sys_seconds time) const noexcept {
+        struct tm tm_time;
+        time_t t = to_time_t(time);
+
+        LWDTC_CFG_GET_LOCALTIME(&tm_time, &t);
+        return lwdtc_cron_is_valid_for_time(&tm_time, &ctx_) == lwdtcOK;
+    }
+
+    /**
+     * \brief           Get next fire time, strictly after the reference time
+     * \param[in]       after: Reference time
+     * \return          Next fire time, `std::nullopt` if cron does not fire anymore
+     */
+    std::optional<std::chrono::sys_seconds>
+    next(std::chrono::sys_seconds after) const noexcept {
+        time_t t;
+
+        if (lwdtc_cron_next(&ctx_, to_time_t(after), &t) != lwdtcOK) {
+            return std::nullopt;
+        }
+        return from_time_t(t);
+    }
+
+    /**
+     * \brief           Get lazy view of all fire times, strictly after the reference time
+     * \param[in]       after: Reference time
+     * \return          View of fire times
+     */
+    times_view times(std::chrono::sys_seconds after) const noexcept;
+
+    /**
+     * \brief           Get underlying C context
+     * \return          Reference to cron context
+     */
+    const lwdtc_cron_ctx_t&
+    ctx() const noexcept {
+        return ctx_;
+    }
+
+  private:
+    cron() noexcept = default;
+
+    static time_t
+    to_time_t(std::chrono::sys_seconds time) noexcept {
+        return static_cast<time_t>(time.time_since_epoch().count());
+    }
+
+    static std::chrono::sys_seconds
+    from_time_t(time_t time) noexcept {
+        return std::chrono::sys_seconds{std::chrono::seconds{time}};
+    }
+
+    lwdtc_cron_ctx_t ctx_{};
+};
+
+/**
+ * \brief           Lazy view of cron fire times
+ *
+ * Each increment searches only for the next fire time, starting from the previous one.
+ * Iterator keeps day cache of the search, so no work is repeated and nothing is allocated.
+ * Range ends when cron does not fire anymore within supported year range.
+ *
+ * View keeps its own copy of the cron, iterators refer to it and must not outlive the view.
+ */
+class cron::times_view : public std::ranges::view_interface<cron::times_view> {
+  public:
+    /**
+     * \brief           Forward iterator over fire times
+     */
+    class iterator {
+      public:
+        using value_type = std::chrono::sys_seconds;
+        using difference_type = std::ptrdiff_t;
+        using iterator_concept = std::forward_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+
+        iterator() noexcept = default;
+
+        value_type
+        operator*() const noexcept {
+            return from_time_t(time_);
+        }
+
+        iterator&
+        operator++() noexcept {
+            advance();
+            return *this;
+        }
+
+        iterator
+        operator++(int) noexcept {
+            iterator tmp = *this;
+            advance();
+            return tmp;
+        }
+
+        friend bool
+        operator==(const iterator& a, const iterator& b) noexcept {
+            return a.done_ == b.done_ && (a.done_ || a.time_ == b.time_);
+        }
+
+        friend bool
+        operator==(const iterator& it, std::default_sentinel_t) noexcept {
+            return it.done_;
+        }
+
+      private:
+        friend class times_view;
+
+        iterator(const lwdtc_cron_ctx_t* ctx, time_t after) noexcept : ctx_{ctx}, time_{after}, done_{false} {
+            lwdtc_cron_daycache_reset(&cache_);
+            advance();
+        }
+
+        void
+        advance() noexcept {
+            if (!done_) {
+                done_ = lwdtc_cron_next_with_cache(ctx_, &cache_, time_, &time_) != lwdtcOK;
+            }
+        }
+
+        const lwdtc_cron_ctx_t* ctx_ = nullptr;
+        lwdtc_cron_daycache_t cache_{};
+        time_t time_ = 0;
+        bool done_ = true;
+    };
+
+    times_view() noexcept = default;
+
+    times_view(const cron& c, std::chrono::sys_seconds after) noexcept : cron_{c}, after_{after} {}
+
+    iterator
+    begin() const noexcept {
+        return iterator{&cron_.ctx_, to_time_t(after_)};
+    }
+
+    std::default_sentinel_t
+    end() const noexcept {
+        return std::default_sentinel;
+    }
+
+  private:
+    cron cron_;
+    std::chrono::sys_seconds after_{};
+};
+
+inline cron::times_view
+cron::times(std::chrono::sys_seconds after) const noexcept {
+    return times_view{*this, after};
+}
+
+} /* namespace lwdtc */
+
+/**
+ * \}
+ */
+
+#endif /* LWDTC_HDR_HPP */
@@ -0,0 +1,92 @@
+/**
+ * \file            lwdtc_agenda.h
+ * \brief           LwDTC agenda of multiple cron contexts
+ */
+
+/*
+ * Copyright (c) 2024 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwDTC - Lightweight Date, Time & Cron library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v1.0.0
+ */
+#ifndef LWDTC_AGENDA_HDR_H
+#define LWDTC_AGENDA_HDR_H
+
+#include "lwdtc/lwdtc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \defgroup        LWDTC_AGENDA Agenda
+ * \brief           All fire times of multiple contexts in a time window, in time order
+ * \{
+ *
+ * Agenda lists every fire time of every context in the window, as \ref lwdtc_agenda_event_t events.
+ * Events are sorted by time, and events at the same time by context index.
+ *
+ * Next fire time of each context is kept in a min-heap, in memory provided by the application,
+ * and events are merged from the heap one by one. Only the context of returned event
+ * is searched for its next fire time, so the cost of a page of events
+ * does not depend on the length of the window.
+ *
+ * Events are read in pages, to the buffer of any size.
+ * Last event of the page is a cursor, that starts the agenda again right after that event,
+ * for example when next page is requested later with new agenda object.
+ */
+
+/**
+ * \brief           Agenda event
+ */
+typedef struct {
+    time_t time;      /*!< Fire time */
+    size_t ctx_index; /*!< Index of the context in the array */
+} lwdtc_agenda_event_t;
+
+/**
+ * \brief           Agenda of multiple contexts
+ */
+typedef struct {
+    const lwdtc_cron_ctx_t* ctx; /*!< Pointer to array of contexts */
+    time_t end;                  /*!< End of the window, not included */
+    lwdtc_agenda_event_t* heap;  /*!< Min-heap with next event of each context */
+    size_t heap_len;             /*!< Number of contexts in the heap */
+} lwdtc_agenda_t;
+
+lwdtcr_t lwdtc_agenda_init(lwdtc_agenda_t* agenda, lwdtc_agenda_event_t* heap, const lwdtc_cron_ctx_t* cron_ctx,
+                           size_t ctx_len, time_t start, time_t end, const lwdtc_agenda_event_t* cursor);
+lwdtcr_t lwdtc_agenda_get(lwdtc_agenda_t* agenda, lwdtc_agenda_event_t* events, size_t events_len,
+                          size_t* events_cnt);
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* LWDTC_AGENDA_HDR_H */
@@ -0,0 +1,67 @@
+/**
+ * \file            lwdtc_excl.h
+ * \brief           LwDTC exclusion calendar
+ */
+
+/*
+ * Copyright (c) 2024 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwDTC - Lightweight Date, Time & Cron library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v1.0.0
+ */
+#ifndef LWDTC_EXCL_HDR_H
+#define LWDTC_EXCL_HDR_H
+
+#include "lwdtc/lwdtc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \defgroup        LWDTC_EXCL Exclusion calendar
+ * \brief           Days when cron never fires, such as public holidays
+ * \{
+ *
+ * Calendar keeps bit-map of excluded days for each year, \ref lwdtc_excl_year_t.
+ * It is used by \ref lwdtc_cron_is_valid_for_time_excl for matching,
+ * and by next time search when set to the day cache with \ref lwdtc_cron_daycache_set_excl.
+ * Excluded days are then skipped at once, as any other non-eligible day.
+ */
+
+lwdtcr_t lwdtc_excl_init(lwdtc_excl_t* excl, lwdtc_excl_year_t* years, size_t years_len);
+lwdtcr_t lwdtc_excl_add(lwdtc_excl_t* excl, int32_t year, uint32_t mon, uint32_t mday);
+lwdtcr_t lwdtc_excl_is_excluded(const lwdtc_excl_t* excl, int32_t year, uint32_t mon, uint32_t mday);
+lwdtcr_t lwdtc_excl_parse(lwdtc_excl_t* excl, const char* str, size_t str_len, size_t* fail_line);
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* LWDTC_EXCL_HDR_H */
@@ -0,0 +1,123 @@
+/**
+ * \file            lwdtc_journal.h
+ * \brief           LwDTC persistent scheduler state journal
+ */
+
+/*
+ * Copyright (c) 2024 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwDTC - Lightweight Date, Time & Cron library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v1.0.0
+ */
+#ifndef LWDTC_JOURNAL_HDR_H
+#define LWDTC_JOURNAL_HDR_H
+
+#include "lwdtc/lwdtc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \defgroup        LWDTC_JOURNAL Scheduler state journal
+ * \brief           Persistent scheduler state with checksummed records
+ * \{
+ *
+ * Journal keeps last-fired and next-due time of every job in a fixed-layout memory region.
+ * Region is provided by the application and may be memory-mapped file,
+ * battery-backed RAM or any other memory that survives restart.
+ *
+ * Every job has two record slots, written alternately.
+ * Interrupted write can damage only one slot, the other one keeps previous valid state.
+ */
+
+#define LWDTC_JOURNAL_MAGIC   0x4C574A4EUL /*!< Journal magic number */
+#define LWDTC_JOURNAL_VERSION 0x0001U      /*!< Journal layout version */
+
+/**
+ * \brief           Journal header, placed at the beginning of the memory region
+ */
+typedef struct {
+    uint32_t magic;       /*!< Magic number, set to \ref LWDTC_JOURNAL_MAGIC */
+    uint16_t version;     /*!< Layout version, set to \ref LWDTC_JOURNAL_VERSION */
+    uint16_t record_size; /*!< Size of single record in units of bytes */
+    uint32_t entries_num; /*!< Number of job entries in the journal */
+    uint32_t crc;         /*!< CRC-32 of all previous fields in the header */
+} lwdtc_journal_hdr_t;
+
+/**
+ * \brief           Single journal record with state of one job
+ */
+typedef struct {
+    uint32_t id;        /*!< Job identifier, defined by application.
+                                Used to detect that the job at this index has changed */
+    uint32_t seq;       /*!< Write sequence number, incremented with wrap-around. Newer record is ahead */
+    int64_t last_fired; /*!< Last time job fired */
+    int64_t next_due;   /*!< Next time job is due to fire */
+    uint32_t reserved;  /*!< Reserved for future use, set to `0` */
+    uint32_t crc;       /*!< CRC-32 of all previous fields in the record */
+} lwdtc_journal_record_t;
+
+/**
+ * \brief           Journal entry of one job, with two alternating record slots
+ */
+typedef struct {
+    lwdtc_journal_record_t slot[2]; /*!< Record slots */
+} lwdtc_journal_entry_t;
+
+/**
+ * \brief           Journal handle
+ */
+typedef struct {
+    lwdtc_journal_hdr_t* hdr;       /*!< Pointer to header in the memory region */
+    lwdtc_journal_entry_t* entries; /*!< Pointer to entries in the memory region */
+    size_t entries_num;             /*!< Number of entries */
+} lwdtc_journal_t;
+
+/**
+ * \brief           Get memory size required for journal with specific number of entries
+ * \param[in]       entries_num: Number of job entries
+ * \return          Size of memory region in units of bytes
+ */
+#define LWDTC_JOURNAL_MEM_SIZE(entries_num)                                                                            \
+    (sizeof(lwdtc_journal_hdr_t) + (size_t)(entries_num) * sizeof(lwdtc_journal_entry_t))
+
+lwdtcr_t lwdtc_journal_format(lwdtc_journal_t* journal, void* mem, size_t mem_size, size_t entries_num);
+lwdtcr_t lwdtc_journal_attach(lwdtc_journal_t* journal, void* mem, size_t mem_size);
+lwdtcr_t lwdtc_journal_write(lwdtc_journal_t* journal, size_t index, uint32_t id, time_t last_fired, time_t next_due);
+lwdtcr_t lwdtc_journal_read(const lwdtc_journal_t* journal, size_t index, uint32_t* id, time_t* last_fired,
+                            time_t* next_due);
+lwdtcr_t lwdtc_journal_get_missed(const lwdtc_journal_t* journal, size_t index, const lwdtc_cron_ctx_t* cron_ctx,
+                                  time_t curr_time, time_t* missed, size_t missed_len, size_t* missed_cnt);
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* LWDTC_JOURNAL_HDR_H */
@@ -66,6 +66,8 @@ extern "C" {
  * 
  * Default implementation uses localtime but user may use gmtime or even create its own implementation,
  * depending on the target system and overall wishes.
+ * Implementation must set year, month, day in a month, day in a week, hour, minute and second fields.
+ * Day in a year and daylight saving time flag are not used.
  * 
  * \param[in]       _struct_tm_ptr_: Pointer variable to `struct tm` type.
  *                      Variable is a pointer type and does not store actual time data.
@@ -76,6 +78,39 @@ extern "C" {
     (void)localtime_s((_struct_tm_ptr_), (_const_time_t_ptr_))
 #endif
 
+/**
+ * \brief           Enables `1` or disables `0` seconds field in the cron
+ * 
+ * When disabled, cron string does not include seconds field,
+ * and cron is only valid at second `0` of every matching minute.
+ * Context is smaller, and next time search steps by minutes.
+ */
+#ifndef LWDTC_CFG_FIELD_SEC
+#define LWDTC_CFG_FIELD_SEC 1
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` year field in the cron
+ * 
+ * When disabled, cron string does not include year field,
+ * and cron is valid in every year.
+ */
+#ifndef LWDTC_CFG_FIELD_YEAR
+#define LWDTC_CFG_FIELD_YEAR 1
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` special operators in day fields
+ * 
+ * When enabled, day in month field supports `L` (last day), `L-n` (`n` days before last day),
+ * `LW` (last week day) and `nW` (week day nearest to day `n`),
+ * and day in week field supports `nL` (last week day `n` in month) and `n#k` (`k`-th week day `n` in month).
+ * Day field bit-maps are bigger for `14` bytes.
+ */
+#ifndef LWDTC_CFG_DAY_SPECIAL
+#define LWDTC_CFG_DAY_SPECIAL 0
+#endif
+
 /**
  * \}
  */
@@ -0,0 +1,59 @@
+/**
+ * \file            lwdtc_private.h
+ * \brief           LwDTC internal functions, shared between library modules
+ */
+
+/*
+ * Copyright (c) 2024 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwDTC - Lightweight Date, Time & Cron library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v1.0.0
+ */
+#ifndef LWDTC_PRIVATE_HDR_H
+#define LWDTC_PRIVATE_HDR_H
+
+#include "lwdtc/lwdtc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*
+ * Functions in this file are not part of the public API,
+ * they are used by library modules only
+ */
+
+uint32_t lwdtci_get_month_days(int32_t year, uint32_t mon);
+
+#if LWDTC_CFG_DAY_SPECIAL
+uint8_t lwdtci_mday_is_set(const uint8_t* map, uint32_t year, uint32_t mon, uint32_t mday, uint32_t wday);
+uint8_t lwdtci_wday_is_set(const uint8_t* map, uint32_t year, uint32_t mon, uint32_t mday, uint32_t wday);
+#endif /* LWDTC_CFG_DAY_SPECIAL */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* LWDTC_PRIVATE_HDR_H */
@@ -0,0 +1,121 @@
+/**
+ * \file            lwdtc_reload.h
+ * \brief           LwDTC incremental reload of cron tables
+ */
+
+/*
+ * Copyright (c) 2024 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwDTC - Lightweight Date, Time & Cron library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v1.0.0
+ */
+#ifndef LWDTC_RELOAD_HDR_H
+#define LWDTC_RELOAD_HDR_H
+
+#include "lwdtc/lwdtc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \defgroup        LWDTC_RELOAD Table reload
+ * \brief           Incremental reload of cron table text, such as crontab file
+ * \{
+ *
+ * Table text has one entry per line, cron string optionally followed by other data, such as command.
+ * Empty lines and lines starting with `#` are ignored.
+ *
+ * Every line is hashed, and new version of the text is compared with the previous one by line hashes.
+ * Only lines that are not part of previous version are parsed, other entries keep their contexts.
+ * Every entry gets ID, that is kept for as long as entry is not removed, even when its line moves.
+ * Line that replaces a line at the same position in the text is reported as changed entry, and keeps its ID.
+ *
+ * Memory for two versions of the table and for the hash index is provided by the application.
+ */
+
+/**
+ * \brief           Size of hash index memory in `uint32_t` words, for maximum number of entries
+ * \param[in]       n: Maximum number of entries
+ */
+#define LWDTC_RELOAD_SCRATCH_LEN(n) (4 * (size_t)(n) + 1)
+
+/**
+ * \brief           Table entry
+ */
+typedef struct {
+    lwdtc_cron_ctx_t ctx; /*!< Parsed cron context */
+    uint64_t hash;        /*!< Hash of the line */
+    uint32_t id;          /*!< Entry ID, starting with `1`. It is kept until entry is removed */
+    uint32_t line;        /*!< Line number in the text, starting with `1` */
+    const char* str;      /*!< Pointer to the line in the text, without leading and trailing spaces.
+                                Valid while the text of this version is kept by the application */
+    size_t str_len;       /*!< Length of the line */
+} lwdtc_reload_entry_t;
+
+/**
+ * \brief           Entry change type
+ */
+typedef enum {
+    LWDTC_RELOAD_ADDED,   /*!< Entry has been added */
+    LWDTC_RELOAD_REMOVED, /*!< Entry has been removed */
+    LWDTC_RELOAD_CHANGED, /*!< Line of the entry has been changed */
+} lwdtc_reload_evt_t;
+
+/**
+ * \brief           Entry change callback
+ * \param[in]       evt: Change type
+ * \param[in]       entry: Entry. For removed entry, this is entry of the previous version
+ * \param[in]       arg: User argument
+ */
+typedef void (*lwdtc_reload_evt_fn)(lwdtc_reload_evt_t evt, const lwdtc_reload_entry_t* entry, void* arg);
+
+/**
+ * \brief           Reloadable table
+ */
+typedef struct {
+    lwdtc_reload_entry_t* entries[2]; /*!< Entry arrays, for current and for the next version */
+    size_t entries_max;               /*!< Maximum number of entries in each version */
+    size_t entries_len;               /*!< Number of entries in current version */
+    uint8_t curr;                     /*!< Index of entry array with current version */
+    uint32_t* scratch;                /*!< Hash index memory */
+    uint32_t next_id;                 /*!< ID of the next added entry */
+} lwdtc_reload_t;
+
+lwdtcr_t lwdtc_reload_init(lwdtc_reload_t* reload, lwdtc_reload_entry_t* entries, size_t entries_max,
+                           uint32_t* scratch);
+lwdtcr_t lwdtc_reload_load(lwdtc_reload_t* reload, const char* str, size_t str_len, lwdtc_reload_evt_fn evt_fn,
+                           void* arg, size_t* fail_line);
+const lwdtc_reload_entry_t* lwdtc_reload_get_entries(const lwdtc_reload_t* reload, size_t* entries_len);
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* LWDTC_RELOAD_HDR_H */
@@ -0,0 +1,93 @@
+/**
+ * \file            lwdtc_rtc.h
+ * \brief           LwDTC RTC alarm programming
+ */
+
+/*
+ * Copyright (c) 2024 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwDTC - Lightweight Date, Time & Cron library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v1.0.0
+ */
+#ifndef LWDTC_RTC_HDR_H
+#define LWDTC_RTC_HDR_H
+
+#include "lwdtc/lwdtc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \defgroup        LWDTC_RTC RTC alarm
+ * \brief           Next fire time as hardware RTC alarm, for tickless low-power scheduling
+ * \{
+ *
+ * Typical RTC alarm compares selected time fields with the calendar of the RTC,
+ * and ignores fields marked as *don't care*.
+ * Device programs the alarm with \ref lwdtc_rtc_alarm_next output and sleeps until the alarm,
+ * instead of waking up every second to check the cron.
+ *
+ * RTC calendar must run in the same local time as \ref LWDTC_CFG_GET_LOCALTIME
+ */
+
+#define LWDTC_RTC_ALARM_SEC        0x01 /*!< Seconds field of the alarm */
+#define LWDTC_RTC_ALARM_MIN        0x02 /*!< Minutes field of the alarm */
+#define LWDTC_RTC_ALARM_HOUR       0x04 /*!< Hours field of the alarm */
+#define LWDTC_RTC_ALARM_MDAY       0x08 /*!< Day in month field of the alarm */
+#define LWDTC_RTC_ALARM_WDAY       0x10 /*!< Week day field of the alarm */
+#define LWDTC_RTC_ALARM_DAY_EITHER 0x80 /*!< Hardware compares day in month or week day, but not both at once */
+
+/**
+ * \brief           RTC alarm settings
+ */
+typedef struct {
+    uint8_t sec;       /*!< Seconds, `0` to `59` */
+    uint8_t min;       /*!< Minutes, `0` to `59` */
+    uint8_t hour;      /*!< Hours, `0` to `23` */
+    uint8_t mday;      /*!< Day in month, `1` to `31` */
+    uint8_t wday;      /*!< Week day, `0` to `6`, `0` is Sunday as in `struct tm` */
+    uint8_t dont_care; /*!< Bit-mask of `LWDTC_RTC_ALARM_x` fields, ignored by the alarm comparator */
+    uint8_t is_fire;   /*!< Set to `1` when cron fires at alarm time,
+                            `0` when alarm is intermediate wake-up and must be computed again */
+    uint8_t is_repeat; /*!< Set to `1` when alarm matches exactly all fire times of the cron.
+                            Alarm then does not need to be programmed again after it fires */
+    size_t ctx_index;  /*!< Index of context that fires at alarm time, valid when `is_fire` is set */
+    time_t time;       /*!< Time when alarm fires */
+} lwdtc_rtc_alarm_t;
+
+lwdtcr_t lwdtc_rtc_alarm_next(const lwdtc_cron_ctx_t* cron_ctx, size_t ctx_len, time_t curr_time, uint8_t hw_fields,
+                              lwdtc_rtc_alarm_t* alarm);
+uint8_t lwdtc_rtc_alarm_is_match(const lwdtc_rtc_alarm_t* alarm, const struct tm* tm_time);
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* LWDTC_RTC_HDR_H */
@@ -0,0 +1,112 @@
+/**
+ * \file            lwdtc_table.h
+ * \brief           LwDTC compact cron table with interned fields
+ */
+
+/*
+ * Copyright (c) 2024 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwDTC - Lightweight Date, Time & Cron library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v1.0.0
+ */
+#ifndef LWDTC_TABLE_HDR_H
+#define LWDTC_TABLE_HDR_H
+
+#include "lwdtc/lwdtc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \defgroup        LWDTC_TABLE Compact table
+ * \brief           Large schedule tables with field bit-maps stored only once
+ * \{
+ *
+ * Field bit-maps repeat heavily across contexts, even when whole cron strings differ.
+ * Seconds field is almost always `0`, while month, week day and year fields are mostly wildcards.
+ * Table keeps every distinct bit-map of each field only once,
+ * and every context is stored as \ref lwdtc_table_entry_t with one index per field.
+ *
+ * Memory for the bit-maps is provided by the application
+ */
+
+/**
+ * \brief           Number of fields in the table entry
+ */
+#define LWDTC_TABLE_FIELDS_NUM (5 + (LWDTC_CFG_FIELD_SEC ? 1 : 0) + (LWDTC_CFG_FIELD_YEAR ? 1 : 0))
+
+#define LWDTC_TABLE_MAPS_MAX   0xFFFEU /*!< Maximum number of distinct bit-maps per field */
+
+/**
+ * \brief           Context in the table, with index of bit-map for every field
+ */
+typedef struct {
+    uint16_t field[LWDTC_TABLE_FIELDS_NUM]; /*!< Bit-map indexes, in the order of fields in \ref lwdtc_cron_ctx_t */
+} lwdtc_table_entry_t;
+
+/**
+ * \brief           Distinct bit-maps of one field
+ */
+typedef struct {
+    uint8_t* maps;   /*!< Bit-maps, one after another */
+    uint16_t* slots; /*!< Hash slots with bit-map index plus `1`, `0` for empty slot */
+    uint8_t* hit;    /*!< Match result for every bit-map, used by \ref lwdtc_table_match */
+    size_t num;      /*!< Number of bit-maps in use */
+} lwdtc_table_pool_t;
+
+/**
+ * \brief           Compact table handle
+ */
+typedef struct {
+    lwdtc_table_pool_t pool[LWDTC_TABLE_FIELDS_NUM]; /*!< Bit-map pool of every field */
+    size_t maps_len;                                 /*!< Maximum number of bit-maps per field */
+} lwdtc_table_t;
+
+/**
+ * \brief           Get memory size required for the table
+ * \param[in]       maps_len: Maximum number of distinct bit-maps per field
+ * \return          Size of memory region in units of bytes
+ */
+#define LWDTC_TABLE_MEM_SIZE(maps_len)                                                                                 \
+    ((size_t)(maps_len) * (sizeof(lwdtc_cron_ctx_t) + LWDTC_TABLE_FIELDS_NUM * (2 * sizeof(uint16_t) + 1)))
+
+lwdtcr_t lwdtc_table_init(lwdtc_table_t* table, void* mem, size_t mem_size, size_t maps_len);
+lwdtcr_t lwdtc_table_add(lwdtc_table_t* table, const lwdtc_cron_ctx_t* cron_ctx, lwdtc_table_entry_t* entry);
+lwdtcr_t lwdtc_table_get_ctx(const lwdtc_table_t* table, const lwdtc_table_entry_t* entry, lwdtc_cron_ctx_t* cron_ctx);
+lwdtcr_t lwdtc_table_is_valid_for_time(const lwdtc_table_t* table, const lwdtc_table_entry_t* entry,
+                                       const struct tm* tm_time);
+lwdtcr_t lwdtc_table_match(lwdtc_table_t* table, const lwdtc_table_entry_t* entries, size_t entries_len,
+                           const struct tm* tm_time, uint8_t* out_bits);
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* LWDTC_TABLE_HDR_H */
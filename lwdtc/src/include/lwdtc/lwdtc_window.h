@@ -0,0 +1,83 @@
+/**
+ * \file            lwdtc_window.h
+ * \brief           LwDTC cron time windows
+ */
+
+/*
+ * Copyright (c) 2024 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwDTC - Lightweight Date, Time & Cron library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v1.0.0
+ */
+#ifndef LWDTC_WINDOW_HDR_H
+#define LWDTC_WINDOW_HDR_H
+
+#include "lwdtc/lwdtc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \defgroup        LWDTC_WINDOW Time windows
+ * \brief           Time windows between open and close cron edges
+ * \{
+ *
+ * Window opens when open context fires. It closes when close context fires,
+ * or after fixed duration from the last open fire time.
+ *
+ * Window keeps its state and the time of the next transition.
+ * State is recalculated only when time reaches the next transition,
+ * or when time goes back before the last calculation.
+ */
+
+/**
+ * \brief           Time window
+ */
+typedef struct {
+    const lwdtc_cron_ctx_t* open_ctx;  /*!< Context that opens the window */
+    const lwdtc_cron_ctx_t* close_ctx; /*!< Context that closes the window. `NULL` when duration is used */
+    time_t duration;                   /*!< Window duration in seconds, used when close context is `NULL` */
+    lwdtc_cron_daycache_t open_cache;  /*!< Day cache for open context */
+    lwdtc_cron_daycache_t close_cache; /*!< Day cache for close context */
+    time_t from;                       /*!< Start of the interval with known state */
+    time_t edge;                       /*!< Next transition time, end of the interval with known state */
+    uint8_t flags;                     /*!< Internal state flags */
+} lwdtc_window_t;
+
+lwdtcr_t lwdtc_window_init(lwdtc_window_t* win, const lwdtc_cron_ctx_t* open_ctx, const lwdtc_cron_ctx_t* close_ctx);
+lwdtcr_t lwdtc_window_init_duration(lwdtc_window_t* win, const lwdtc_cron_ctx_t* open_ctx, time_t duration);
+uint8_t lwdtc_window_is_active(lwdtc_window_t* win, time_t curr_time);
+lwdtcr_t lwdtc_window_next_edge(lwdtc_window_t* win, time_t curr_time, time_t* edge_time);
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* LWDTC_WINDOW_HDR_H */
@@ -34,6 +34,7 @@
 #include <stdint.h>
 #include <string.h>
 #include "lwdtc/lwdtc.h"
+#include "lwdtc/lwdtc_private.h"
 
 #if defined(LWDTC_DEV)
 #include <stdio.h>
@@ -56,6 +57,313 @@
 
 #define BIT_IS_SET(map, pos)  ((map)[(pos) >> 3U] & (1U << ((pos) & 0x07U)))
 #define BIT_SET(map, pos)     (map)[(pos) >> 3U] |= (1U << ((pos) & 0x07U))
+#define BIT_MAP_OR(dst, src)                                                                                           \
+    for (size_t _i_ = 0; _i_ < sizeof(dst); ++_i_) {                                                                   \
+        (dst)[_i_] |= (src)[_i_];                                                                                      \
+    }
+
+/*
+ * Field identifiers, used to describe evaluation order in the context flags.
+ *
+ * Fields compiled out by the configuration get no identifier
+ */
+#define PRV_FIELD_SEC_CNT     (LWDTC_CFG_FIELD_SEC ? 1 : 0)
+#define PRV_FIELD_YEAR_CNT    (LWDTC_CFG_FIELD_YEAR ? 1 : 0)
+#if LWDTC_CFG_FIELD_SEC
+#define PRV_FIELD_SEC 0x00
+#endif /* LWDTC_CFG_FIELD_SEC */
+#define PRV_FIELD_MIN  (0x00 + PRV_FIELD_SEC_CNT)
+#define PRV_FIELD_HOUR (0x01 + PRV_FIELD_SEC_CNT)
+#define PRV_FIELD_MDAY (0x02 + PRV_FIELD_SEC_CNT)
+#define PRV_FIELD_MON  (0x03 + PRV_FIELD_SEC_CNT)
+#define PRV_FIELD_WDAY (0x04 + PRV_FIELD_SEC_CNT)
+#if LWDTC_CFG_FIELD_YEAR
+#define PRV_FIELD_YEAR (0x05 + PRV_FIELD_SEC_CNT)
+#endif /* LWDTC_CFG_FIELD_YEAR */
+#define PRV_FIELD_NUM (0x05 + PRV_FIELD_SEC_CNT + PRV_FIELD_YEAR_CNT) /*!< Number of fields in the context */
+#define PRV_FIELD_END 0x07                                            /*!< End of evaluation order marker */
+
+#if LWDTC_CFG_DAY_SPECIAL
+/*
+ * Special day operators are bits in day field bit-maps, above the range of field values.
+ *
+ * Bit-maps stay monotonic: more bits never mean fewer valid days,
+ * and union of two bit-maps is valid exactly on union of their days.
+ *
+ * Operators are evaluated from the date and its week day, that every caller already has.
+ * Week of the month is "(mday - 1) / 7", and month length comes from the month length table,
+ * hence there is no table of first week days per month, that would need an entry for every month and year
+ */
+#define PRV_MDAY_BIT_LAST(n)    (32U + (n)) /*!< `L-n`, `n` days before last day in month, `0` to `30` */
+#define PRV_MDAY_BIT_LW         63U         /*!< `LW`, last week day in month */
+#define PRV_MDAY_BIT_NEAR(d)    (64U + (d)) /*!< `dW`, week day nearest to day `d`, `1` to `31` */
+#define PRV_WDAY_BIT_NTH(w, k)  (8U * (k) + (w)) /*!< `w#k`, `k`-th week day `w` in month, `1` to `5` */
+#define PRV_WDAY_BIT_LAST(w)    (48U + (w))      /*!< `wL`, last week day `w` in month */
+#define PRV_MDAY_IS_SET(ctx, y, m, d, w) lwdtci_mday_is_set((ctx)->mday, (y), (m), (d), (w))
+#define PRV_WDAY_IS_SET(ctx, y, m, d, w) lwdtci_wday_is_set((ctx)->wday, (y), (m), (d), (w))
+#else
+#define PRV_MDAY_IS_SET(ctx, y, m, d, w) BIT_IS_SET((ctx)->mday, (d))
+#define PRV_WDAY_IS_SET(ctx, y, m, d, w) BIT_IS_SET((ctx)->wday, (w))
+#endif /* LWDTC_CFG_DAY_SPECIAL */
+
+/*
+ * Check seconds and year values against the context.
+ *
+ * Without seconds field, cron is valid at second 0 only.
+ * Without year field, cron is valid in every year
+ */
+#if LWDTC_CFG_FIELD_SEC
+#define PRV_SEC_IS_SET(ctx, s) BIT_IS_SET((ctx)->sec, (s))
+/* Check 2 seconds interval, starting at second "2 * s2", with one test of two adjacent bits */
+#define PRV_SEC2_IS_SET(ctx, s2) ((((uint32_t)(ctx)->sec[(s2) >> 2U] >> (((s2) & 0x03U) << 1U)) & 0x03U) != 0)
+#else
+#define PRV_SEC_IS_SET(ctx, s)   ((s) == 0)
+#define PRV_SEC2_IS_SET(ctx, s2) ((s2) == 0)
+#endif /* LWDTC_CFG_FIELD_SEC */
+#if LWDTC_CFG_FIELD_YEAR
+#define PRV_YEAR_IS_SET(ctx, y) ((y) <= LWDTC_YEAR_MAX && BIT_IS_SET((ctx)->year, (y)))
+#else
+#define PRV_YEAR_IS_SET(ctx, y) ((void)(y), 1)
+#endif /* LWDTC_CFG_FIELD_YEAR */
+
+/*
+ * Context flags layout:
+ *
+ * - Bits 0-2: Most selective field, checked first. PRV_FIELD_END when all fields are wildcards
+ * - Bits 3-9: Wildcard mask, one bit per field, set when all values of the field are valid.
+ *             Wildcard fields are skipped when cron is checked
+ * - Bits 10-12: Schedule shape, one of PRV_SHAPE_* values, for closed-form next time calculation
+ * - Bit 31: Flags have been prepared by the parser. When not set, all fields are checked in default order
+ */
+#define PRV_FLAG_FIRST_MASK   0x07UL /*!< Most selective field, first to check */
+#define PRV_FLAG_WILDCARD(f)  (1UL << (3U + (f)))
+#define PRV_FLAG_SHAPE(s)     ((uint32_t)(s) << 10U)
+#define PRV_FLAG_SHAPE_GET(f) (((f) >> 10U) & 0x07UL)
+#define PRV_FLAG_PREPARED     (1UL << 31U)
+
+/* Schedule shapes */
+#define PRV_SHAPE_GENERIC     0x00 /*!< Any other schedule, generic search is used */
+#define PRV_SHAPE_INTERVAL    0x01 /*!< Seconds and minutes set, all other fields are wildcards */
+#define PRV_SHAPE_DAILY       0x02 /*!< Single time of day, all day fields are wildcards */
+#define PRV_SHAPE_WEEKLY      0x03 /*!< Single time of day, on selected week days */
+#define PRV_SHAPE_MONTHLY     0x04 /*!< Single time of day, on selected days in month */
+
+/* Get bit-map of specific field */
+#define PRV_FIELD_MAP(ctx, f)    ((const uint8_t*)(ctx) + prv_fields[(f)].offset)
+#define PRV_FIELD_MAP_RW(ctx, f) ((uint8_t*)(ctx) + prv_fields[(f)].offset)
+#define PRV_FIELD_SIZE(f)        ((size_t)prv_fields[(f)].size)
+#define PRV_FIELD_VAL_SIZE(f)    ((size_t)(prv_fields[(f)].val_max >> 3U) + 1U)
+
+/* Step types for the next time calculation, ordered from the smallest to the largest */
+#define PRV_STEP_NONE         0x00 /*!< No step, cron is valid for current time */
+#define PRV_STEP_SEC          0x01 /*!< Go to next second */
+#define PRV_STEP_MIN          0x02 /*!< Go to beginning of next minute */
+#define PRV_STEP_HALF_HOUR    0x03 /*!< Go to beginning of next half an hour */
+#define PRV_STEP_DAY          0x04 /*!< Go to next eligible day */
+
+/*
+ * Find next set bit of seconds field, from position to LWDTC_SEC_MAX.
+ * Returns LWDTC_SEC_MAX + 1 when there is none
+ */
+#if LWDTC_CFG_FIELD_SEC
+#define PRV_SEC_NEXT(ctx, s) prv_next_bit((ctx)->sec, (s), LWDTC_SEC_MAX)
+#else
+#define PRV_SEC_NEXT(ctx, s) ((s) == 0 ? 0U : LWDTC_SEC_MAX + 1U)
+#endif /* LWDTC_CFG_FIELD_SEC */
+
+/* Number of days from 1970-01-01 to January 1st of the year, for years after 1970 */
+#define PRV_DAYS_TO_YEAR(y)  (365LL * ((y) - 1970) + ((y) - 1) / 4 - ((y) - 1) / 100 + ((y) - 1) / 400 - 477)
+
+/*
+ * Check if time is within supported year range, with one day margin for any local time offset.
+ * Shape calculations that do not convert to local time check the range first
+ */
+#if LWDTC_CFG_FIELD_YEAR
+#define PRV_TIME_IN_RANGE(t)                                                                                           \
+    ((int64_t)(t) >= (PRV_DAYS_TO_YEAR(2000) + 1) * 86400LL                                                            \
+     && (int64_t)(t) < (PRV_DAYS_TO_YEAR(2001 + LWDTC_YEAR_MAX) - 1) * 86400LL)
+#else
+#define PRV_TIME_IN_RANGE(t) ((t) >= 86400)
+#endif /* LWDTC_CFG_FIELD_YEAR */
+
+/* Count trailing zeros in non-zero 32-bit value */
+#if defined(__GNUC__)
+#define PRV_CTZ(x) ((uint32_t)__builtin_ctz(x))
+#else
+static uint32_t
+PRV_CTZ(uint32_t x) {
+    uint32_t cnt = 0;
+    for (; (x & 0x01U) == 0; x >>= 1U, ++cnt) {}
+    return cnt;
+}
+#endif /* defined(__GNUC__) */
+
+/* Number of set bits in each 4-bit value */
+static const uint8_t prv_nibble_bits[] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
+
+/* Number of days in each month, for non-leap year */
+static const uint8_t prv_month_days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+
+/**
+ * \brief           Check if year is a leap year
+ * \param[in]       year: Full year number
+ * \return          `1` if leap year, `0` otherwise
+ */
+static uint8_t
+prv_is_leap_year(int32_t year) {
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+/**
+ * \brief           Get number of days in a month
+ * \param[in]       year: Full year number
+ * \param[in]       mon: Month, `1` to `12`
+ * \return          Number of days
+ */
+uint32_t
+lwdtci_get_month_days(int32_t year, uint32_t mon) {
+    return prv_month_days[mon - 1] + (uint32_t)(mon == 2 && prv_is_leap_year(year));
+}
+
+#if LWDTC_CFG_DAY_SPECIAL
+
+/**
+ * \brief           Check if any special day operator is set in the context
+ * \param[in]       cron_ctx: Cron context object with valid structure
+ * \return          `1` if special operator is set, `0` otherwise
+ */
+static uint8_t
+prv_has_day_special(const lwdtc_cron_ctx_t* cron_ctx) {
+    uint8_t val = 0;
+
+    for (size_t i = (LWDTC_MDAY_MAX >> 3U) + 1U; i < sizeof(cron_ctx->mday); ++i) {
+        val |= cron_ctx->mday[i];
+    }
+    for (size_t i = (LWDTC_WDAY_MAX >> 3U) + 1U; i < sizeof(cron_ctx->wday); ++i) {
+        val |= cron_ctx->wday[i];
+    }
+    return val != 0;
+}
+
+/**
+ * \brief           Check day in month field, including special day operators
+ * \param[in]       map: Day in month bit-map of the context
+ * \param[in]       year: Year offset from year `2000`
+ * \param[in]       mon: Month, `1` to `12`
+ * \param[in]       mday: Day in a month, `1` to `31`
+ * \param[in]       wday: Day in a week, `0` (Sunday) to `6` (Saturday)
+ * \return          `1` if day is valid, `0` otherwise
+ */
+uint8_t
+lwdtci_mday_is_set(const uint8_t* map, uint32_t year, uint32_t mon, uint32_t mday, uint32_t wday) {
+    uint32_t mdays;
+
+    if (BIT_IS_SET(map, mday)) {
+        return 1;
+    }
+    mdays = lwdtci_get_month_days((int32_t)(2000 + year), mon);
+    if (BIT_IS_SET(map, PRV_MDAY_BIT_LAST(mdays - mday))) {
+        return 1;
+    }
+
+    /* Week day operators are never valid at the weekend */
+    if (wday == 0 || wday == 6) {
+        return 0;
+    }
+
+    /* Last week day is Friday, when month ends at the weekend */
+    if (BIT_IS_SET(map, PRV_MDAY_BIT_LW) && mdays - mday <= (wday == 5 ? 2U : 0U)) {
+        return 1;
+    }
+
+    /*
+     * Week day nearest to day "d" is the day itself, Friday before Saturday or Monday after Sunday,
+     * but never in other month: Saturday 1st moves to Monday 3rd and last day Sunday moves to Friday.
+     *
+     * Check all the days that move to current day
+     */
+    if (BIT_IS_SET(map, PRV_MDAY_BIT_NEAR(mday))) {
+        return 1;
+    }
+    if (wday == 5) {
+        return (mday + 1 <= mdays && BIT_IS_SET(map, PRV_MDAY_BIT_NEAR(mday + 1)))
+               || (mday + 2 == mdays && BIT_IS_SET(map, PRV_MDAY_BIT_NEAR(mday + 2)));
+    } else if (wday == 1) {
+        return (mday > 1 && BIT_IS_SET(map, PRV_MDAY_BIT_NEAR(mday - 1)))
+               || (mday == 3 && BIT_IS_SET(map, PRV_MDAY_BIT_NEAR(1)));
+    }
+    return 0;
+}
+
+/**
+ * \brief           Check week day field, including special day operators
+ * \param[in]       map: Week day bit-map of the context
+ * \param[in]       year: Year offset from year `2000`
+ * \param[in]       mon: Month, `1` to `12`
+ * \param[in]       mday: Day in a month, `1` to `31`
+ * \param[in]       wday: Day in a week, `0` (Sunday) to `6` (Saturday)
+ * \return          `1` if day is valid, `0` otherwise
+ */
+uint8_t
+lwdtci_wday_is_set(const uint8_t* map, uint32_t year, uint32_t mon, uint32_t mday, uint32_t wday) {
+    uint32_t mdays;
+
+    if (BIT_IS_SET(map, wday) || BIT_IS_SET(map, PRV_WDAY_BIT_NTH(wday, (mday - 1) / 7U + 1U))) {
+        return 1;
+    }
+    mdays = lwdtci_get_month_days((int32_t)(2000 + year), mon);
+    return mday + 7U > mdays && BIT_IS_SET(map, PRV_WDAY_BIT_LAST(wday));
+}
+
+#endif /* LWDTC_CFG_DAY_SPECIAL */
+
+/**
+ * \brief           Find next set bit in the bit-map
+ * \param[in]       map: Bit-map
+ * \param[in]       pos: First position to check
+ * \param[in]       max: Last position to check
+ * \return          Position of next set bit, `max + 1` if there is none
+ */
+static uint32_t
+prv_next_bit(const uint8_t* map, uint32_t pos, uint32_t max) {
+    for (; pos <= max; pos = (pos | 0x07U) + 1) {
+        uint32_t bits = (uint32_t)map[pos >> 3U] >> (pos & 0x07U);
+
+        if (bits != 0) {
+            pos += PRV_CTZ(bits);
+            return pos <= max ? pos : max + 1;
+        }
+    }
+    return max + 1;
+}
+
+/**
+ * \brief           Count set bits in the bit-map, at positions lower than the limit
+ * \param[in]       map: Bit-map
+ * \param[in]       limit: Number of positions to count, starting at `0`
+ * \return          Number of set bits
+ */
+static uint32_t
+prv_count_bits(const uint8_t* map, uint32_t limit) {
+    uint32_t cnt = 0, i;
+
+    for (i = 0; i < (limit >> 3U); ++i) {
+        cnt += prv_nibble_bits[map[i] & 0x0FU] + prv_nibble_bits[map[i] >> 4U];
+    }
+    if (limit & 0x07U) {
+        uint32_t last = map[i] & ((1U << (limit & 0x07U)) - 1U);
+
+        cnt += prv_nibble_bits[last & 0x0FU] + prv_nibble_bits[last >> 4U];
+    }
+    return cnt;
+}
+
+/* Count set bits of seconds field, at positions lower than the limit */
+#if LWDTC_CFG_FIELD_SEC
+#define PRV_SEC_COUNT(ctx, limit) prv_count_bits((ctx)->sec, (limit))
+#else
+#define PRV_SEC_COUNT(ctx, limit) ((limit) > 0 ? 1U : 0U)
+#endif /* LWDTC_CFG_FIELD_SEC */
 
 /**
  * \brief           Private structure to parse cron input
@@ -70,8 +378,42 @@ typedef struct {
     /* Generated token for particular field */
     const char* new_token; /*!< Start of new parsed token */
     size_t new_token_len;  /*!< Length of new parsed token */
+
+    /* Job key for hashed values */
+    const char* key; /*!< Job key, `NULL` when hashed values are not allowed */
+    size_t key_len;  /*!< Length of job key */
+    uint8_t field;   /*!< Index of field being parsed, mixed into the hash */
 } prv_cron_parser_ctx_t;
 
+/**
+ * \brief           Field descriptor
+ */
+typedef struct {
+    uint8_t offset;  /*!< Offset of the field bit-map in the context structure */
+    uint8_t size;    /*!< Size of the field bit-map in bytes */
+    uint8_t val_min; /*!< Minimum allowed value */
+    uint8_t val_max; /*!< Maximum allowed value */
+} prv_field_desc_t;
+
+/* Field descriptor initializer */
+#define PRV_FIELD_DESC(field, min, max)                                                                                \
+    {offsetof(lwdtc_cron_ctx_t, field), sizeof(((lwdtc_cron_ctx_t*)0)->field), (min), (max)}
+
+/* List of fields, indexed by PRV_FIELD_* values */
+static const prv_field_desc_t prv_fields[PRV_FIELD_NUM] = {
+#if LWDTC_CFG_FIELD_SEC
+    PRV_FIELD_DESC(sec, LWDTC_SEC_MIN, LWDTC_SEC_MAX),
+#endif /* LWDTC_CFG_FIELD_SEC */
+    PRV_FIELD_DESC(min, LWDTC_MIN_MIN, LWDTC_MIN_MAX),
+    PRV_FIELD_DESC(hour, LWDTC_HOUR_MIN, LWDTC_HOUR_MAX),
+    PRV_FIELD_DESC(mday, LWDTC_MDAY_MIN, LWDTC_MDAY_MAX),
+    PRV_FIELD_DESC(mon, LWDTC_MON_MIN, LWDTC_MON_MAX),
+    PRV_FIELD_DESC(wday, LWDTC_WDAY_MIN, LWDTC_WDAY_MAX),
+#if LWDTC_CFG_FIELD_YEAR
+    PRV_FIELD_DESC(year, LWDTC_YEAR_MIN, LWDTC_YEAR_MAX),
+#endif /* LWDTC_CFG_FIELD_YEAR */
+};
+
 /**
  * \brief           Parse a number from a string in decimal format.
  * \param[in]       token: Pointer to token string to parse, that starts with number
@@ -98,6 +440,32 @@ prv_parse_num(const char* token, size_t max_len, size_t* index, size_t* out_num)
     return lwdtcOK;
 }
 
+#define PRV_MDAY_HASH_MAX 28 /*!< Last day for hashed value in day in month field, present in every month */
+
+/**
+ * \brief           Get hash of the job key for currently parsed field
+ * 
+ * Jenkins one-at-a-time hash is used, with field index appended to the key,
+ * so that each field gets different value for the same key.
+ * 
+ * \param[in]       parser: Parser structure with all input data
+ * \return          Hash value
+ */
+static uint32_t
+prv_key_hash(const prv_cron_parser_ctx_t* parser) {
+    uint32_t hash = 0;
+
+    for (size_t i = 0; i <= parser->key_len; ++i) {
+        hash += i < parser->key_len ? (uint8_t)parser->key[i] : parser->field;
+        hash += hash << 10U;
+        hash ^= hash >> 6U;
+    }
+    hash += hash << 3U;
+    hash ^= hash >> 11U;
+    hash += hash << 15U;
+    return hash;
+}
+
 /**
  * \brief           Get start of next token from a list
  * \param[in,out]   parser: Parser structure with all input data
@@ -125,6 +493,77 @@ prv_get_next_token(prv_cron_parser_ctx_t* parser) {
     return lwdtcOK;
 }
 
+#if LWDTC_CFG_DAY_SPECIAL
+
+/**
+ * \brief           Parse special day operator of day in month or week day field
+ * 
+ * Day in month field accepts `L`, `L-n`, `LW` and `nW`, week day field accepts `nL` and `n#k`.
+ * Operators are stored as bits above the range of field values
+ * 
+ * \param[in,out]   parser: Parser structure with all input data
+ * \param[in]       bit_map: Byte array to construct bit-map for valid cron
+ * \param[in,out]   index: Index of the item in current token.
+ *                      It is advanced to the end of the item, when item is parsed
+ * \return          \ref lwdtcOK if item was parsed, \ref lwdtcERR if item is not special operator,
+ *                      member of \ref lwdtcr_t otherwise
+ */
+static lwdtcr_t
+prv_parse_day_special(prv_cron_parser_ctx_t* parser, uint8_t* bit_map, size_t* index) {
+    const char* tok = &parser->new_token[*index];
+    size_t len = parser->new_token_len - *index, idx = 0, num = 0, num2;
+
+    if (bit_map == parser->ctx->mday) {
+        if (tok[0] == 'L') {
+            ++idx;
+            if (idx < len && tok[idx] == 'W') {
+                ++idx;
+                BIT_SET(bit_map, PRV_MDAY_BIT_LW);
+            } else {
+                if (idx < len && tok[idx] == '-') {
+                    ++idx;
+                    ASSERT_TOKEN_VALID(prv_parse_num(&tok[idx], len - idx, &idx, &num) == lwdtcOK);
+                    ASSERT_TOKEN_VALID(num <= LWDTC_MDAY_MAX - 1);
+                }
+                BIT_SET(bit_map, PRV_MDAY_BIT_LAST(num));
+            }
+        } else {
+            /* Number must be followed by "W" */
+            for (; idx < len && CHAR_IS_NUM(tok[idx]); ++idx) {}
+            if (idx == 0 || idx == len || tok[idx] != 'W') {
+                return lwdtcERR;
+            }
+            idx = 0;
+            ASSERT_TOKEN_VALID(prv_parse_num(tok, len, &idx, &num) == lwdtcOK);
+            ASSERT_TOKEN_VALID(LWDTC_MDAY_MIN <= num && num <= LWDTC_MDAY_MAX);
+            ++idx;
+            BIT_SET(bit_map, PRV_MDAY_BIT_NEAR(num));
+        }
+    } else if (bit_map == parser->ctx->wday) {
+        /* Number must be followed by "L" or "#" */
+        for (; idx < len && CHAR_IS_NUM(tok[idx]); ++idx) {}
+        if (idx == 0 || idx == len || (tok[idx] != 'L' && tok[idx] != '#')) {
+            return lwdtcERR;
+        }
+        idx = 0;
+        ASSERT_TOKEN_VALID(prv_parse_num(tok, len, &idx, &num) == lwdtcOK);
+        ASSERT_TOKEN_VALID(num <= LWDTC_WDAY_MAX);
+        if (tok[idx++] == 'L') {
+            BIT_SET(bit_map, PRV_WDAY_BIT_LAST(num));
+        } else {
+            ASSERT_TOKEN_VALID(idx < len && prv_parse_num(&tok[idx], len - idx, &idx, &num2) == lwdtcOK);
+            ASSERT_TOKEN_VALID(1 <= num2 && num2 <= 5);
+            BIT_SET(bit_map, PRV_WDAY_BIT_NTH(num, num2));
+        }
+    } else {
+        return lwdtcERR;
+    }
+    *index += idx;
+    return lwdtcOK;
+}
+
+#endif /* LWDTC_CFG_DAY_SPECIAL */
+
 /**
  * \brief           Parses string token and sets appropriate bits in the
  *                      cron field bit-map, indicating when particular cron is valid
@@ -138,9 +577,13 @@ static lwdtcr_t
 prv_get_and_parse_next_token(prv_cron_parser_ctx_t* parser, uint8_t* bit_map, size_t val_min, size_t val_max) {
     size_t idx = 0, bit_start_pos, bit_end_pos, bit_step;
     uint8_t is_range, is_opposite;
+#if LWDTC_CFG_DAY_SPECIAL
+    lwdtcr_t res;
+#endif /* LWDTC_CFG_DAY_SPECIAL */
 
     /* Get next token from string */
     ASSERT_ACTION(prv_get_next_token(parser) == lwdtcOK);
+    ++parser->field;
 
     /*
      * Process token string in a while loop
@@ -156,10 +599,25 @@ prv_get_and_parse_next_token(prv_cron_parser_ctx_t* parser, uint8_t* bit_map, si
 
         ASSERT_ACTION(idx < parser->new_token_len); /* Check token length */
 
+#if LWDTC_CFG_DAY_SPECIAL
+        /* Special day operators are complete items, followed by comma or end of token */
+        res = prv_parse_day_special(parser, bit_map, &idx);
+        if (res == lwdtcOK) {
+            if (idx == parser->new_token_len) {
+                break;
+            }
+            ASSERT_TOKEN_VALID(parser->new_token[idx] == ',');
+            continue;
+        } else if (res != lwdtcERR) {
+            return res;
+        }
+#endif /* LWDTC_CFG_DAY_SPECIAL */
+
         /*
-         * Token starts with one of 2 possible values:
+         * Token starts with one of 3 possible values:
          *
          * - "*", indicating all values in the field available range
+         * - "H", indicating value derived from the job key hash, see below
          * - digit, indicating fixed bit position
          * 
          * Followed by first character, second step is optional:
@@ -178,6 +636,11 @@ prv_get_and_parse_next_token(prv_cron_parser_ctx_t* parser, uint8_t* bit_map, si
          * - "* /step": All values between possible minimum and maximum for specific field,
          *          step defined by number
          *          (space between * and / is used to be able to keep it as C comment for this example)
+         * - "H": Single value between possible minimum and maximum, derived from job key hash.
+         *          Day in month field uses maximum of 28, to keep the job firing in every month
+         * - "H(min-max)": Single value between min and max, derived from job key hash
+         * - "H/step": Values with step, starting at offset (lower than step) derived from job key hash
+         * - "H(min-max)/step": Values between min and max with step, starting at offset derived from job key hash
          */
 
         /* Find start character first */
@@ -192,6 +655,52 @@ prv_get_and_parse_next_token(prv_cron_parser_ctx_t* parser, uint8_t* bit_map, si
              */
             bit_start_pos = val_min;
             bit_end_pos = val_max;
+        } else if (parser->new_token[idx] == 'H') {
+            uint32_t hash;
+
+            ++idx;
+            ASSERT_TOKEN_VALID(parser->key != NULL);
+            bit_start_pos = val_min;
+            bit_end_pos = bit_map == parser->ctx->mday ? PRV_MDAY_HASH_MAX : val_max;
+
+            /* Optional range in parenthesis */
+            if (idx < parser->new_token_len && parser->new_token[idx] == '(') {
+                ++idx;
+                ASSERT_ACTION(idx < parser->new_token_len);
+                ASSERT_TOKEN_VALID(
+                    prv_parse_num(&parser->new_token[idx], parser->new_token_len - idx, &idx, &bit_start_pos)
+                    == lwdtcOK);
+                ASSERT_TOKEN_VALID(idx + 1 < parser->new_token_len && parser->new_token[idx] == '-');
+                ++idx;
+                ASSERT_TOKEN_VALID(
+                    prv_parse_num(&parser->new_token[idx], parser->new_token_len - idx, &idx, &bit_end_pos)
+                    == lwdtcOK);
+                ASSERT_TOKEN_VALID(idx < parser->new_token_len && parser->new_token[idx] == ')');
+                ++idx;
+                ASSERT_TOKEN_VALID(val_min <= bit_start_pos && bit_start_pos <= bit_end_pos && bit_end_pos <= val_max);
+            }
+
+            /*
+             * Hash selects single value within the range,
+             * or offset of the first value when step is used.
+             *
+             * Range or step are not allowed to follow the hashed value
+             */
+            hash = prv_key_hash(parser);
+            if (idx < parser->new_token_len && parser->new_token[idx] == '/') {
+                ++idx;
+                ASSERT_TOKEN_VALID(
+                    prv_parse_num(&parser->new_token[idx], parser->new_token_len - idx, &idx, &bit_step) == lwdtcOK);
+                ASSERT_TOKEN_VALID(bit_step > 0);
+                if (bit_step > bit_end_pos - bit_start_pos) {
+                    bit_step = bit_end_pos - bit_start_pos + 1; /* Offset must stay within the range */
+                }
+                bit_start_pos += hash % bit_step;
+            } else {
+                bit_start_pos += hash % (bit_end_pos - bit_start_pos + 1);
+                bit_end_pos = bit_start_pos;
+            }
+            ASSERT_TOKEN_VALID(idx == parser->new_token_len || parser->new_token[idx] == ',');
         } else {
             /*
              * Specific number has been entered by user and represents at least bit minimum position,
@@ -301,6 +810,76 @@ prv_get_and_parse_next_token(prv_cron_parser_ctx_t* parser, uint8_t* bit_map, si
     return lwdtcOK;
 }
 
+/**
+ * \brief           Prepare context flags after all fields have been set
+ * 
+ * It marks fields that are full wildcards (all values valid),
+ * and selects most selective of remaining fields, that is checked first.
+ * Field is more selective when smaller portion of its available range is valid.
+ * Schedule is then classified to the shape, used for closed-form next time calculation.
+ * 
+ * \param[in,out]   ctx: Cron context with all fields set
+ */
+static void
+prv_prepare_flags(lwdtc_cron_ctx_t* ctx) {
+    uint8_t cnt[PRV_FIELD_NUM], range[PRV_FIELD_NUM], sec_cnt;
+    uint32_t flags = PRV_FLAG_PREPARED, days_mask, first = PRV_FIELD_END;
+
+    for (size_t f = 0; f < PRV_FIELD_NUM; ++f) {
+        const uint8_t* map = PRV_FIELD_MAP(ctx, f);
+
+        /* Count number of valid values in the field, special day operators are not counted */
+        cnt[f] = 0;
+        range[f] = prv_fields[f].val_max - prv_fields[f].val_min + 1;
+        for (size_t i = 0; i < PRV_FIELD_VAL_SIZE(f); ++i) {
+            cnt[f] += prv_nibble_bits[map[i] & 0x0FU] + prv_nibble_bits[map[i] >> 4U];
+        }
+        if (cnt[f] == range[f]) {
+            flags |= PRV_FLAG_WILDCARD(f);
+            continue;
+        }
+
+        /* Keep field with the lowest ratio of valid values (cnt / range) */
+        if (first == PRV_FIELD_END || (cnt[f] * range[first]) < (cnt[first] * range[f])) {
+            first = (uint32_t)f;
+        }
+    }
+    flags |= first;
+
+    /* Classify the shape, empty fields always use generic search */
+#if LWDTC_CFG_FIELD_SEC
+    sec_cnt = cnt[PRV_FIELD_SEC];
+#else
+    sec_cnt = 1;
+#endif /* LWDTC_CFG_FIELD_SEC */
+    days_mask = PRV_FLAG_WILDCARD(PRV_FIELD_MDAY) | PRV_FLAG_WILDCARD(PRV_FIELD_MON) | PRV_FLAG_WILDCARD(PRV_FIELD_WDAY);
+#if LWDTC_CFG_FIELD_YEAR
+    days_mask |= PRV_FLAG_WILDCARD(PRV_FIELD_YEAR);
+#endif /* LWDTC_CFG_FIELD_YEAR */
+#if LWDTC_CFG_DAY_SPECIAL
+    if (prv_has_day_special(ctx)) {
+        /* Special day operators always use generic search */
+    } else
+#endif /* LWDTC_CFG_DAY_SPECIAL */
+    if ((flags & days_mask) == days_mask && (flags & PRV_FLAG_WILDCARD(PRV_FIELD_HOUR)) && sec_cnt > 0
+        && cnt[PRV_FIELD_MIN] > 0) {
+        flags |= PRV_FLAG_SHAPE(PRV_SHAPE_INTERVAL);
+    } else if (sec_cnt == 1 && cnt[PRV_FIELD_MIN] == 1 && cnt[PRV_FIELD_HOUR] == 1) {
+        /* Month and year must be wildcards, one of the day fields may be set */
+        days_mask &= ~(uint32_t)(PRV_FLAG_WILDCARD(PRV_FIELD_MDAY) | PRV_FLAG_WILDCARD(PRV_FIELD_WDAY));
+        if ((flags & days_mask) != days_mask) {
+            /* Not a shape */
+        } else if ((flags & PRV_FLAG_WILDCARD(PRV_FIELD_MDAY)) && (flags & PRV_FLAG_WILDCARD(PRV_FIELD_WDAY))) {
+            flags |= PRV_FLAG_SHAPE(PRV_SHAPE_DAILY);
+        } else if ((flags & PRV_FLAG_WILDCARD(PRV_FIELD_MDAY)) && cnt[PRV_FIELD_WDAY] > 0) {
+            flags |= PRV_FLAG_SHAPE(PRV_SHAPE_WEEKLY);
+        } else if ((flags & PRV_FLAG_WILDCARD(PRV_FIELD_WDAY)) && cnt[PRV_FIELD_MDAY] > 0) {
+            flags |= PRV_FLAG_SHAPE(PRV_SHAPE_MONTHLY);
+        }
+    }
+    ctx->flags = flags;
+}
+
 /**
  * \brief           Parse string with linux crontab-like syntax,
  *                  optionally enriched according to configured settings
@@ -312,6 +891,27 @@ prv_get_and_parse_next_token(prv_cron_parser_ctx_t* parser, uint8_t* bit_map, si
  */
 lwdtcr_t
 lwdtc_cron_parse_with_len(lwdtc_cron_ctx_t* ctx, const char* cron_str, size_t cron_str_len) {
+    return lwdtc_cron_parse_with_key(ctx, cron_str, cron_str_len, NULL, 0);
+}
+
+/**
+ * \brief           Parse string with linux crontab-like syntax, with support for hashed values
+ * 
+ * Hashed value `H` is resolved to deterministic value, derived from the job key.
+ * Jobs with different keys and the same cron string are spread evenly across the field,
+ * while each job keeps stable schedule.
+ * 
+ * \param[in]       ctx: Cron context variable used for storing parsed result
+ * \param[in]       cron_str: Input cron string to parse data, using valid cron format recognized by the lib
+ * \param[in]       cron_str_len: Length of input cron string,
+ *                      not counting potential `NULL` termination character
+ * \param[in]       key: Job key used for hashed values. When set to `NULL`, hashed values are not allowed
+ * \param[in]       key_len: Length of job key
+ * \return          \ref lwdtcOK on success, member of \ref lwdtcr_t otherwise
+ */
+lwdtcr_t
+lwdtc_cron_parse_with_key(lwdtc_cron_ctx_t* ctx, const char* cron_str, size_t cron_str_len, const char* key,
+                          size_t key_len) {
     prv_cron_parser_ctx_t parser = {0};
     lwdtcr_t res;
 
@@ -322,6 +922,8 @@ lwdtc_cron_parse_with_len(lwdtc_cron_ctx_t* ctx, const char* cron_str, size_t cr
     parser.ctx = ctx;
     parser.cron_str = cron_str;
     parser.cron_str_len = cron_str_len;
+    parser.key = key;
+    parser.key_len = key_len;
 
     /*
      * Start parsing fields in fixed order.
@@ -338,10 +940,12 @@ lwdtc_cron_parse_with_len(lwdtc_cron_ctx_t* ctx, const char* cron_str, size_t cr
         }                                                                                                              \
     } while (0)
 
+#if LWDTC_CFG_FIELD_SEC
     /* Parse seconds field */
     ASSERT_GET_PARSE_TOKEN(prv_get_and_parse_next_token(&parser, ctx->sec, LWDTC_SEC_MIN, LWDTC_SEC_MAX));
     LWDTC_DEBUG("Seconds token: len: %d, token: %.*s, rem_len: %d\r\n", (int)parser.new_token_len,
                 (int)parser.new_token_len, parser.new_token, (int)parser.cron_str_len);
+#endif /* LWDTC_CFG_FIELD_SEC */
 
     /* Parse minutes field */
     ASSERT_GET_PARSE_TOKEN(prv_get_and_parse_next_token(&parser, ctx->min, LWDTC_MIN_MIN, LWDTC_MIN_MAX));
@@ -368,10 +972,15 @@ lwdtc_cron_parse_with_len(lwdtc_cron_ctx_t* ctx, const char* cron_str, size_t cr
     LWDTC_DEBUG("Weekday token: len: %d, token: %.*s, rem_len: %d\r\n", (int)parser.new_token_len,
                 (int)parser.new_token_len, parser.new_token, (int)parser.cron_str_len);
 
+#if LWDTC_CFG_FIELD_YEAR
     /* Parse year field */
     ASSERT_GET_PARSE_TOKEN(prv_get_and_parse_next_token(&parser, ctx->year, LWDTC_YEAR_MIN, LWDTC_YEAR_MAX));
     LWDTC_DEBUG("Year token: len: %d, token: %.*s, rem_len: %d\r\n", (int)parser.new_token_len,
                 (int)parser.new_token_len, parser.new_token, (int)parser.cron_str_len);
+#endif /* LWDTC_CFG_FIELD_YEAR */
+
+    /* Prepare flags for faster evaluation */
+    prv_prepare_flags(ctx);
     return res;
 }
 
@@ -417,6 +1026,23 @@ lwdtc_cron_parse_multi(lwdtc_cron_ctx_t* cron_ctx, const char** cron_strs, size_
     return res;
 }
 
+/**
+ * \brief           Prepare context for evaluation, after its fields have been set by the application.
+ *                  Parser calls it for every parsed context
+ * \param[in,out]   ctx: Cron context with all fields set
+ * \return          \ref lwdtcOK on success, member of \ref lwdtcr_t otherwise
+ */
+lwdtcr_t
+lwdtc_cron_prepare(lwdtc_cron_ctx_t* ctx) {
+    ASSERT_PARAM(ctx != NULL);
+
+    prv_prepare_flags(ctx);
+    return lwdtcOK;
+}
+
+/* Check field, that is not a wildcard in the prepared flags */
+#define PRV_FIELD_CHECK(flags, f, is_set) (((flags) & PRV_FLAG_WILDCARD(f)) || (is_set))
+
 /**
  * \brief           Check if cron is active at specific moment of time,
  *                      provided as parameter
@@ -428,7 +1054,7 @@ lwdtc_cron_parse_multi(lwdtc_cron_ctx_t* cron_ctx, const char** cron_strs, size_
  */
 lwdtcr_t
 lwdtc_cron_is_valid_for_time(const struct tm* tm_time, const lwdtc_cron_ctx_t* cron_ctx) {
-    lwdtcr_t res = lwdtcOK;
+    uint32_t year, mon, mday, wday, flags;
 
     ASSERT_PARAM(tm_time != NULL && cron_ctx != NULL);
 
@@ -441,91 +1067,957 @@ lwdtc_cron_is_valid_for_time(const struct tm* tm_time, const lwdtc_cron_ctx_t* c
      * 
      * Our cron is a valid when bitwise AND-ed between all fields is a pass
      */
-    if (!BIT_IS_SET(cron_ctx->sec, (uint32_t)tm_time->tm_sec) || !BIT_IS_SET(cron_ctx->min, (uint32_t)tm_time->tm_min)
-        || !BIT_IS_SET(cron_ctx->hour, (uint32_t)tm_time->tm_hour)
-        || !BIT_IS_SET(cron_ctx->mday, (uint32_t)tm_time->tm_mday)
-        || !BIT_IS_SET(cron_ctx->mon, (uint32_t)(tm_time->tm_mon + 1))
-        || !BIT_IS_SET(cron_ctx->wday, (uint32_t)tm_time->tm_wday)
-        || !BIT_IS_SET(cron_ctx->year, (uint32_t)(tm_time->tm_year - 100))) {
-        res = lwdtcERR;
+    year = (uint32_t)(tm_time->tm_year - 100);
+    mon = (uint32_t)(tm_time->tm_mon + 1);
+    mday = (uint32_t)tm_time->tm_mday;
+    wday = (uint32_t)tm_time->tm_wday;
+    flags = cron_ctx->flags;
+
+    /*
+     * Check most selective field first, as prepared by the parser,
+     * to reject mismatch as early as possible.
+     *
+     * Seconds are checked first anyway, no need for special check
+     */
+    switch (flags & (PRV_FLAG_PREPARED | PRV_FLAG_FIRST_MASK)) {
+        case PRV_FLAG_PREPARED | PRV_FIELD_MIN:
+            if (!BIT_IS_SET(cron_ctx->min, (uint32_t)tm_time->tm_min)) {
+                return lwdtcERR;
+            }
+            break;
+        case PRV_FLAG_PREPARED | PRV_FIELD_HOUR:
+            if (!BIT_IS_SET(cron_ctx->hour, (uint32_t)tm_time->tm_hour)) {
+                return lwdtcERR;
+            }
+            break;
+        case PRV_FLAG_PREPARED | PRV_FIELD_MDAY:
+            if (!PRV_MDAY_IS_SET(cron_ctx, year, mon, mday, wday)) {
+                return lwdtcERR;
+            }
+            break;
+        case PRV_FLAG_PREPARED | PRV_FIELD_MON:
+            if (!BIT_IS_SET(cron_ctx->mon, mon)) {
+                return lwdtcERR;
+            }
+            break;
+        case PRV_FLAG_PREPARED | PRV_FIELD_WDAY:
+            if (!PRV_WDAY_IS_SET(cron_ctx, year, mon, mday, wday)) {
+                return lwdtcERR;
+            }
+            break;
+        default: break;
     }
-    return res;
+
+    /*
+     * Wildcard fields are skipped, all fields are checked when flags are not prepared.
+     * Year is always checked for range, as its bit-map doesn't cover all possible values
+     */
+    if (
+#if LWDTC_CFG_FIELD_SEC
+        !PRV_FIELD_CHECK(flags, PRV_FIELD_SEC, PRV_SEC_IS_SET(cron_ctx, (uint32_t)tm_time->tm_sec))
+#else
+        !PRV_SEC_IS_SET(cron_ctx, (uint32_t)tm_time->tm_sec)
+#endif /* LWDTC_CFG_FIELD_SEC */
+        || !PRV_FIELD_CHECK(flags, PRV_FIELD_MIN, BIT_IS_SET(cron_ctx->min, (uint32_t)tm_time->tm_min))
+        || !PRV_FIELD_CHECK(flags, PRV_FIELD_HOUR, BIT_IS_SET(cron_ctx->hour, (uint32_t)tm_time->tm_hour))
+        || !PRV_FIELD_CHECK(flags, PRV_FIELD_MON, BIT_IS_SET(cron_ctx->mon, mon))
+        || !PRV_FIELD_CHECK(flags, PRV_FIELD_MDAY, PRV_MDAY_IS_SET(cron_ctx, year, mon, mday, wday))
+        || !PRV_FIELD_CHECK(flags, PRV_FIELD_WDAY, PRV_WDAY_IS_SET(cron_ctx, year, mon, mday, wday))
+        || !PRV_YEAR_IS_SET(cron_ctx, year)) {
+        return lwdtcERR;
+    }
+    return lwdtcOK;
 }
 
 /**
- * \brief           Get next time of fire for specific cron object
- * 
- * This is a dirty implementation and could be improved in the future.
- * For now, we start with one second after current time, and do the roll
- * over all values until we have a match.
- * 
- * \param           cron_ctx: CRON context object
- * \param           curr_time: Current time, used as reference to get new time
- * \param[out]      new_time: Pointer to new time value
- * \return          \ref lwdtcOK on success, member of \ref lwdtcr_t otherwise 
+ * \brief           Get number of days from 1970-01-01 to the date, in proleptic Gregorian calendar
+ * \param[in]       year: Full year number
+ * \param[in]       mon: Month, `1` to `12`
+ * \param[in]       mday: Day in a month, `1` to `31`
+ * \return          Number of days, negative for dates before 1970-01-01
  */
-lwdtcr_t
-lwdtc_cron_next(const lwdtc_cron_ctx_t* cron_ctx, time_t curr_time, time_t* new_time) {
-    lwdtcr_t res = lwdtcOK;
-    struct tm tm_time;
-
-    ASSERT_PARAM(cron_ctx != NULL);
-    ASSERT_PARAM(new_time != NULL);
-
-    /* Go to next second, ignore current actual time */
-    ++curr_time;
-    LWDTC_CFG_GET_LOCALTIME(&tm_time, &curr_time);
-    while (lwdtc_cron_is_valid_for_time(&tm_time, cron_ctx) != lwdtcOK) {
-        /* 
-         * Does the CRON happen in this hour?
-         *
-         * We do not jump for more than an hour, to avoid any timezone issues.
-         * We assume timezone mismatch is not greather than 30min (1800 seconds)
-         */
-        if (!BIT_IS_SET(cron_ctx->mday, (uint32_t)tm_time.tm_mday)
-            || !BIT_IS_SET(cron_ctx->wday, (uint32_t)tm_time.tm_wday)
-            || !BIT_IS_SET(cron_ctx->hour, (uint32_t)tm_time.tm_hour)) {
-            curr_time += 1800U - (curr_time % 1800U); /* Increase with the beg of a minute alignment */
-        } else if (!BIT_IS_SET(cron_ctx->min, (uint32_t)tm_time.tm_min)) {
-            /* Does the CRON happen in this minute? */
-            curr_time += 60U - (curr_time % 60U); /* Go to the beg of next minute */
-        } else { /* It happens in this minute, so just increase seconds counter and try again */
-            ++curr_time;
-            if (++tm_time.tm_sec <= LWDTC_SEC_MAX) {
-                continue;
-            }
-        }
+static int32_t
+prv_days_from_civil(int32_t year, uint32_t mon, uint32_t mday) {
+    int32_t era;
+    uint32_t yoe, doy, doe;
 
-        /* Get new local time after all the updates */
-        LWDTC_CFG_GET_LOCALTIME(&tm_time, &curr_time);
-    }
-    *new_time = curr_time;
-    return res;
+    year -= mon <= 2;
+    era = (year >= 0 ? year : year - 399) / 400;
+    yoe = (uint32_t)(year - era * 400);
+    doy = (153U * (mon > 2 ? mon - 3 : mon + 9) + 2U) / 5U + mday - 1U;
+    doe = yoe * 365U + yoe / 4U - yoe / 100U + doy;
+    return era * 146097 + (int32_t)doe - 719468;
 }
 
 /**
- * \brief           Check if current time fits to at least one of provided context arrays (OR operation)
- * \param[in]       tm_time: Current time to check if cron works for it.
- *                      Function assumes values in the structure are within valid boundaries
- *                      and does not perform additional check
- * \param[in]       cron_ctx: Pointer to array of cron ctx objects
- * \param[in]       ctx_len: Number of context array length
- * \return          \ref lwdtcOK on success, member of \ref lwdtcr_t otherwise 
+ * \brief           Convert time to broken-down time, in UTC, with arithmetic only
+ * \param[out]      tm_time: Broken-down time
+ * \param[in]       time: Time to convert
  */
-lwdtcr_t
-lwdtc_cron_is_valid_for_time_multi_or(const struct tm* tm_time, const lwdtc_cron_ctx_t* cron_ctx, size_t ctx_len) {
-    lwdtcr_t res = lwdtcERR;
-
-    ASSERT_PARAM(cron_ctx != NULL && tm_time != NULL && ctx_len > 0);
+static void
+prv_time_to_tm(struct tm* tm_time, time_t time) {
+    int64_t days = (int64_t)time / 86400, sod = (int64_t)time % 86400, era, z;
+    uint32_t doe, yoe, doy, mp;
 
-    /* Multi-cron context version of lwdtc_cron_is_valid_for_time */
-    while (ctx_len-- > 0) {
-        res = lwdtc_cron_is_valid_for_time(tm_time, cron_ctx++);
-        if (res == lwdtcOK) {
-            break;
-        }
+    if (sod < 0) {
+        sod += 86400;
+        --days;
     }
-    return res;
+
+    /* Civil date from number of days since 1970-01-01 */
+    z = days + 719468;
+    era = (z >= 0 ? z : z - 146096) / 146097;
+    doe = (uint32_t)(z - era * 146097);
+    yoe = (doe - doe / 1460U + doe / 36524U - doe / 146096U) / 365U;
+    doy = doe - (365U * yoe + yoe / 4U - yoe / 100U);
+    mp = (5U * doy + 2U) / 153U;
+
+    LWDTC_MEMSET(tm_time, 0x00, sizeof(*tm_time));
+    tm_time->tm_mday = (int)(doy - (153U * mp + 2U) / 5U + 1U);
+    tm_time->tm_mon = (int)(mp < 10U ? mp + 2U : mp - 10U);
+    tm_time->tm_year = (int)((int64_t)yoe + era * 400 + (tm_time->tm_mon <= 1) - 1900);
+    tm_time->tm_yday = (int)(days - prv_days_from_civil(tm_time->tm_year + 1900, 1, 1));
+    tm_time->tm_wday = (int)((days % 7 + 11) % 7); /* 1970-01-01 was Thursday */
+    tm_time->tm_hour = (int)(sod / 3600);
+    tm_time->tm_min = (int)((sod / 60) % 60);
+    tm_time->tm_sec = (int)(sod % 60);
+}
+
+/**
+ * \brief           Get local time in specific time zone
+ * \param[in]       tz: Time zone. When `NULL`, \ref LWDTC_CFG_GET_LOCALTIME is used
+ * \param[out]      tm_time: Broken-down local time
+ * \param[in]       time: Time to convert
+ */
+static void
+prv_get_localtime(const lwdtc_tz_t* tz, struct tm* tm_time, const time_t* time) {
+    if (tz == NULL) {
+        LWDTC_CFG_GET_LOCALTIME(tm_time, time);
+    } else if (tz->get_time != NULL) {
+        tz->get_time(tm_time, time, tz->arg);
+    } else {
+        prv_time_to_tm(tm_time, *time + tz->utc_offset);
+    }
+}
+
+/**
+ * \brief           Check if cron may be valid at specific day, considering day-level fields only
+ * \param[in]       cron_ctx: Cron context object with valid structure
+ * \param[in]       year: Year offset from year `2000`
+ * \param[in]       mon: Month, `1` to `12`
+ * \param[in]       mday: Day in a month, `1` to `31`
+ * \param[in]       wday: Day in a week, `0` (Sunday) to `6` (Saturday)
+ * \return          `1` if day is eligible, `0` otherwise
+ */
+static uint8_t
+prv_is_day_valid(const lwdtc_cron_ctx_t* cron_ctx, uint32_t year, uint32_t mon, uint32_t mday, uint32_t wday) {
+    return PRV_YEAR_IS_SET(cron_ctx, year) && BIT_IS_SET(cron_ctx->mon, mon)
+           && PRV_MDAY_IS_SET(cron_ctx, year, mon, mday, wday) && PRV_WDAY_IS_SET(cron_ctx, year, mon, mday, wday);
+}
+
+/**
+ * \brief           Get bit-map of excluded days for specific year
+ * \param[in]       excl: Exclusion calendar, may be `NULL`
+ * \param[in]       year: Full year number
+ * \return          Pointer to bit-map, `NULL` if year has no excluded days
+ */
+static const uint32_t*
+prv_excl_get_year(const lwdtc_excl_t* excl, int32_t year) {
+    if (excl != NULL) {
+        for (size_t i = 0; i < excl->years_num && excl->years[i].year <= year; ++i) {
+            if (excl->years[i].year == year) {
+                return excl->years[i].days;
+            }
+        }
+    }
+    return NULL;
+}
+
+/**
+ * \brief           Get day in a year from year, month and day in a month of local time
+ * 
+ * Day in a year field of the structure is not used, as it may not be set by the application
+ * 
+ * \param[in]       tm_time: Local time within the day
+ * \return          Day in a year, `0` is January 1st
+ */
+static uint32_t
+prv_get_yday(const struct tm* tm_time) {
+    return (uint32_t)(prv_days_from_civil(tm_time->tm_year + 1900, (uint32_t)tm_time->tm_mon + 1,
+                                          (uint32_t)tm_time->tm_mday)
+                      - prv_days_from_civil(tm_time->tm_year + 1900, 1, 1));
+}
+
+/**
+ * \brief           Check if day is excluded by the calendar
+ * \param[in]       excl: Exclusion calendar, may be `NULL`
+ * \param[in]       tm_time: Local time within the day
+ * \return          `1` if excluded, `0` otherwise
+ */
+static uint8_t
+prv_excl_is_set(const lwdtc_excl_t* excl, const struct tm* tm_time) {
+    const uint32_t* days = prv_excl_get_year(excl, tm_time->tm_year + 1900);
+    uint32_t yday;
+
+    if (days == NULL) {
+        return 0;
+    }
+    yday = prv_get_yday(tm_time);
+    return yday < 32U * LWDTC_ARRAYSIZE(excl->years[0].days) && (days[yday >> 5U] & (1UL << (yday & 0x1FU)));
+}
+
+/**
+ * \brief           Build day cache for specific year, if not already built
+ * \param[in]       cron_ctx: Cron context object with valid structure
+ * \param[in,out]   cache: Day cache to build
+ * \param[in]       year: Full year number
+ */
+static void
+prv_daycache_build(const lwdtc_cron_ctx_t* cron_ctx, lwdtc_cron_daycache_t* cache, int32_t year) {
+    uint32_t yday = 0, wday, year_offset = (uint32_t)(year - 2000);
+    const uint32_t* excl_days;
+
+    if (cache->ctx == cron_ctx && cache->year == year) {
+        return;
+    }
+    LWDTC_MEMSET(cache->days, 0x00, sizeof(cache->days));
+    cache->ctx = cron_ctx;
+    cache->year = year;
+
+    /* Year not supported by the cron, leave all days empty */
+    if (!PRV_YEAR_IS_SET(cron_ctx, year_offset)) {
+        return;
+    }
+
+    /* Week day of January 1st, knowing that 1970-01-01 was Thursday */
+    wday = (uint32_t)((prv_days_from_civil(year, 1, 1) % 7 + 11) % 7);
+    for (uint32_t mon = LWDTC_MON_MIN; mon <= LWDTC_MON_MAX; ++mon) {
+        uint32_t mdays = lwdtci_get_month_days(year, mon);
+
+        for (uint32_t mday = 1; mday <= mdays; ++mday, ++yday, wday = wday == LWDTC_WDAY_MAX ? 0 : wday + 1) {
+            if (prv_is_day_valid(cron_ctx, year_offset, mon, mday, wday)) {
+                cache->days[yday >> 5U] |= 1UL << (yday & 0x1FU);
+            }
+        }
+    }
+
+    /* Remove excluded days */
+    if ((excl_days = prv_excl_get_year(cache->excl, year)) != NULL) {
+        for (size_t i = 0; i < LWDTC_ARRAYSIZE(cache->days); ++i) {
+            cache->days[i] &= ~excl_days[i];
+        }
+    }
+}
+
+/**
+ * \brief           Move time to the next eligible day
+ * 
+ * Next eligible day is found in the day cache, without any local time conversion.
+ * Time is then moved to 2 hours before local midnight of that day,
+ * to stay on the safe side with daylight saving time changes.
+ * Remaining part is covered by regular steps.
+ * 
+ * \param[in]       cron_ctx: Cron context object with valid structure
+ * \param[in,out]   cache: Day cache for the context
+ * \param[in,out]   curr_time: Current time to modify
+ * \param[in,out]   tm_time: Local time of current time, updated by the function
+ * \return          `1` on success, `0` if there is no eligible day in supported year range,
+ *                      or in the next `400` years when year field is disabled
+ */
+static uint8_t
+prv_skip_days(const lwdtc_cron_ctx_t* cron_ctx, lwdtc_cron_daycache_t* cache, time_t* curr_time, struct tm* tm_time) {
+    int32_t year = tm_time->tm_year + 1900, days;
+    uint32_t yday = prv_get_yday(tm_time) + 1, word;
+    time_t new_time;
+
+    /* Search starts at the next day, year by year */
+    while (1) {
+#if LWDTC_CFG_FIELD_YEAR
+        if (year - 2000 > LWDTC_YEAR_MAX) {
+            return 0;
+        }
+#else
+        /* Calendar repeats every 400 years, no need to search further */
+        if (year - (tm_time->tm_year + 1900) > 400) {
+            return 0;
+        }
+#endif /* LWDTC_CFG_FIELD_YEAR */
+        prv_daycache_build(cron_ctx, cache, year);
+        for (; yday < 32U * LWDTC_ARRAYSIZE(cache->days); yday = (yday | 0x1FU) + 1) {
+            word = cache->days[yday >> 5U] & (0xFFFFFFFFUL << (yday & 0x1FU));
+            if (word != 0) {
+                yday = (yday & ~0x1FU) + PRV_CTZ(word);
+                break;
+            }
+        }
+        if (yday < 32U * LWDTC_ARRAYSIZE(cache->days)) {
+            break;
+        }
+        ++year;
+        yday = 0;
+    }
+
+    /* Go to the beginning of the day, minus safety margin */
+    days = prv_days_from_civil(year, 1, 1) + (int32_t)yday
+           - prv_days_from_civil(tm_time->tm_year + 1900, (uint32_t)tm_time->tm_mon + 1, (uint32_t)tm_time->tm_mday);
+    new_time = *curr_time - (tm_time->tm_hour * 3600 + tm_time->tm_min * 60 + tm_time->tm_sec) + (time_t)days * 86400
+               - 7200;
+    if (new_time > *curr_time) {
+        *curr_time = new_time;
+    } else {
+        /* Too close to jump, use regular half an hour step */
+        *curr_time += (time_t)(30 - tm_time->tm_min % 30) * 60 - (*curr_time % 60);
+    }
+    prv_get_localtime(cache->tz, tm_time, curr_time);
+    return 1;
+}
+
+/**
+ * \brief           Get step type required to reach potential next match of the cron
+ * 
+ * We do not jump for more than half an hour within the day, to avoid any timezone issues.
+ * Half an hour steps are aligned to local time, local time offset is assumed to be multiple of a minute
+ * 
+ * \param[in]       tm_time: Current time to check
+ * \param[in]       cron_ctx: Cron context object with valid structure
+ * \return          `PRV_STEP_NONE` if cron is valid for current time,
+ *                      one of other `PRV_STEP_*` values otherwise
+ */
+static uint8_t
+prv_get_step(const struct tm* tm_time, const lwdtc_cron_ctx_t* cron_ctx) {
+    /* Does the CRON happen in this day? */
+    if (!prv_is_day_valid(cron_ctx, (uint32_t)(tm_time->tm_year - 100), (uint32_t)(tm_time->tm_mon + 1),
+                          (uint32_t)tm_time->tm_mday, (uint32_t)tm_time->tm_wday)) {
+        return PRV_STEP_DAY;
+    }
+    /* Does the CRON happen in this hour? */
+    if (!BIT_IS_SET(cron_ctx->hour, (uint32_t)tm_time->tm_hour)) {
+        return PRV_STEP_HALF_HOUR;
+    }
+    /* Does the CRON happen in this minute? */
+    if (!BIT_IS_SET(cron_ctx->min, (uint32_t)tm_time->tm_min)) {
+        return PRV_STEP_MIN;
+    }
+    /* Does the CRON happen in this second? */
+    if (!PRV_SEC_IS_SET(cron_ctx, (uint32_t)tm_time->tm_sec)) {
+        return LWDTC_CFG_FIELD_SEC ? PRV_STEP_SEC : PRV_STEP_MIN;
+    }
+    return PRV_STEP_NONE;
+}
+
+/**
+ * \brief           Move time to the next position, according to the step type
+ * \param[in]       step: Step type, one of `PRV_STEP_*` values, except `PRV_STEP_NONE`
+ * \param[in]       cron_ctx: Cron context object, used for day step
+ * \param[in,out]   cache: Day cache for the context, used for day step
+ * \param[in,out]   curr_time: Current time to modify
+ * \param[in,out]   tm_time: Local time of current time, updated by the function
+ * \return          `1` on success, `0` if there is no eligible day in supported year range
+ */
+static uint8_t
+prv_do_step(uint8_t step, const lwdtc_cron_ctx_t* cron_ctx, lwdtc_cron_daycache_t* cache, time_t* curr_time,
+            struct tm* tm_time) {
+    if (step == PRV_STEP_DAY) {
+        return prv_skip_days(cron_ctx, cache, curr_time, tm_time);
+    } else if (step == PRV_STEP_HALF_HOUR) {
+        /* Go to the beg of next local half an hour, for any offset that is multiple of a minute */
+        *curr_time += (time_t)(30 - tm_time->tm_min % 30) * 60 - (*curr_time % 60);
+    } else if (step == PRV_STEP_MIN) {
+        *curr_time += 60U - (*curr_time % 60U); /* Go to the beg of next minute */
+    } else {                                    /* It happens in this minute, so just increase seconds counter */
+        ++(*curr_time);
+        if (++tm_time->tm_sec <= LWDTC_SEC_MAX) {
+            return 1;
+        }
+    }
+
+    /* Get new local time after all the updates */
+    prv_get_localtime(cache->tz, tm_time, curr_time);
+    return 1;
+}
+
+/**
+ * \brief           Get next time of fire with closed-form calculation for the schedule shape
+ * 
+ * Interval with wildcard minutes is calculated on the epoch only,
+ * local time offset is assumed to be multiple of a minute.
+ * Other shapes convert current time to local time, calculate the candidate,
+ * and verify it with another local time conversion.
+ * Candidate that does not match, because local time offset changed in-between,
+ * is rejected and generic search is used instead.
+ * Local time offset is assumed not to change and change back between current time and the candidate.
+ * 
+ * \param[in]       cron_ctx: Cron context object with prepared flags
+ * \param[in]       tz: Time zone, `NULL` for \ref LWDTC_CFG_GET_LOCALTIME
+ * \param[in]       curr_time: Current time, used as reference to get new time
+ * \param[out]      new_time: Pointer to new time value
+ * \return          `1` if new time has been calculated, `0` if generic search must be used
+ */
+static uint8_t
+prv_shape_next(const lwdtc_cron_ctx_t* cron_ctx, const lwdtc_tz_t* tz, time_t curr_time, time_t* new_time) {
+    struct tm tm_time;
+    uint32_t shape = PRV_FLAG_SHAPE_GET(cron_ctx->flags), sec, min, hour;
+    int32_t days = 0, diff;
+    time_t time;
+
+    ++curr_time;
+    if (shape == PRV_SHAPE_INTERVAL && (cron_ctx->flags & PRV_FLAG_WILDCARD(PRV_FIELD_MIN))) {
+        if (!PRV_TIME_IN_RANGE(curr_time)) {
+            return 0;
+        }
+        time = curr_time - curr_time % 60;
+        if ((sec = PRV_SEC_NEXT(cron_ctx, (uint32_t)(curr_time % 60))) > LWDTC_SEC_MAX) {
+            time += 60;
+            sec = PRV_SEC_NEXT(cron_ctx, 0);
+        }
+        *new_time = time + (time_t)sec;
+        return PRV_TIME_IN_RANGE(*new_time);
+    }
+
+    prv_get_localtime(tz, &tm_time, &curr_time);
+    if (shape == PRV_SHAPE_INTERVAL) {
+        /* Next valid second in current minute, or first valid second of next valid minute */
+        min = (uint32_t)tm_time.tm_min;
+        sec = BIT_IS_SET(cron_ctx->min, min) ? PRV_SEC_NEXT(cron_ctx, (uint32_t)tm_time.tm_sec) : LWDTC_SEC_MAX + 1;
+        if (sec > LWDTC_SEC_MAX) {
+            if ((min = prv_next_bit(cron_ctx->min, min + 1, LWDTC_MIN_MAX)) > LWDTC_MIN_MAX) {
+                min = prv_next_bit(cron_ctx->min, 0, LWDTC_MIN_MAX) + LWDTC_MIN_MAX + 1;
+            }
+            sec = PRV_SEC_NEXT(cron_ctx, 0);
+        }
+        time = curr_time + (time_t)(((int32_t)min - tm_time.tm_min) * 60 + ((int32_t)sec - tm_time.tm_sec));
+        min %= LWDTC_MIN_MAX + 1;
+        prv_get_localtime(tz, &tm_time, &time);
+        hour = (uint32_t)tm_time.tm_hour; /* Any hour is valid */
+    } else if (shape != PRV_SHAPE_GENERIC) {
+        /* Single time of day, today if not passed yet */
+        sec = PRV_SEC_NEXT(cron_ctx, 0);
+        min = prv_next_bit(cron_ctx->min, 0, LWDTC_MIN_MAX);
+        hour = prv_next_bit(cron_ctx->hour, 0, LWDTC_HOUR_MAX);
+        diff = (int32_t)(hour * 3600 + min * 60 + sec) - (tm_time.tm_hour * 3600 + tm_time.tm_min * 60 + tm_time.tm_sec);
+        days = diff < 0;
+
+        /* Move to the first eligible day */
+        if (shape == PRV_SHAPE_WEEKLY) {
+            for (uint32_t wday = (uint32_t)(tm_time.tm_wday + days) % 7; !BIT_IS_SET(cron_ctx->wday, wday);
+                 wday = (wday + 1) % 7) {
+                ++days;
+            }
+        } else if (shape == PRV_SHAPE_MONTHLY) {
+            int32_t year = tm_time.tm_year + 1900;
+            uint32_t mon = (uint32_t)tm_time.tm_mon + 1, mday = (uint32_t)tm_time.tm_mday + (uint32_t)days, mdays;
+
+            /* Day 31 is found in at most 2 months, smaller days in the first one */
+            while (1) {
+                mdays = lwdtci_get_month_days(year, mon);
+                if ((mday = prv_next_bit(cron_ctx->mday, mday, mdays)) <= mdays) {
+                    break;
+                }
+                mday = 1;
+                if (++mon > LWDTC_MON_MAX) {
+                    mon = LWDTC_MON_MIN;
+                    ++year;
+                }
+            }
+            days = prv_days_from_civil(year, mon, mday)
+                   - prv_days_from_civil(tm_time.tm_year + 1900, (uint32_t)tm_time.tm_mon + 1,
+                                         (uint32_t)tm_time.tm_mday);
+        }
+        time = curr_time + (time_t)diff + (time_t)days * 86400;
+        prv_get_localtime(tz, &tm_time, &time);
+    } else {
+        return 0;
+    }
+
+    /* Verify the candidate */
+    if ((uint32_t)tm_time.tm_sec != sec || (uint32_t)tm_time.tm_min != min || (uint32_t)tm_time.tm_hour != hour
+        || !PRV_YEAR_IS_SET(cron_ctx, (uint32_t)(tm_time.tm_year - 100))) {
+        return 0;
+    }
+    *new_time = time;
+    return 1;
+}
+
+/**
+ * \brief           Get next time of fire for specific cron object
+ * 
+ * We start with one second after current time, and do the roll
+ * over all values until we have a match.
+ * Days when cron cannot be valid are skipped at once, using per-year day cache.
+ * 
+ * \param           cron_ctx: CRON context object
+ * \param           curr_time: Current time, used as reference to get new time
+ * \param[out]      new_time: Pointer to new time value
+ * \return          \ref lwdtcOK on success, \ref lwdtcERR if cron never fires in supported year range,
+ *                      member of \ref lwdtcr_t otherwise 
+ */
+lwdtcr_t
+lwdtc_cron_next(const lwdtc_cron_ctx_t* cron_ctx, time_t curr_time, time_t* new_time) {
+    lwdtc_cron_daycache_t cache;
+
+    LWDTC_MEMSET(&cache, 0x00, sizeof(cache));
+    return lwdtc_cron_next_with_cache(cron_ctx, &cache, curr_time, new_time);
+}
+
+/**
+ * \brief           Get next time of fire for specific cron object, using persistent day cache
+ * 
+ * Cache keeps bit-map of eligible days for one year, and is built lazily when day needs to be skipped.
+ * It is rebuilt automatically when used with different context or year.
+ * When context at the same address is modified, call \ref lwdtc_cron_daycache_reset first.
+ * 
+ * \param           cron_ctx: CRON context object
+ * \param[in,out]   cache: Day cache object, dedicated to the context.
+ *                      Must be reset with \ref lwdtc_cron_daycache_reset before first use
+ * \param           curr_time: Current time, used as reference to get new time
+ * \param[out]      new_time: Pointer to new time value
+ * \return          \ref lwdtcOK on success, \ref lwdtcERR if cron never fires in supported year range,
+ *                      member of \ref lwdtcr_t otherwise 
+ */
+lwdtcr_t
+lwdtc_cron_next_with_cache(const lwdtc_cron_ctx_t* cron_ctx, lwdtc_cron_daycache_t* cache, time_t curr_time,
+                           time_t* new_time) {
+    struct tm tm_time;
+    uint8_t step;
+
+    ASSERT_PARAM(cron_ctx != NULL && cache != NULL);
+    ASSERT_PARAM(new_time != NULL);
+
+    /* Common shapes are calculated directly, when there are no excluded days */
+    if (cache->excl == NULL && prv_shape_next(cron_ctx, cache->tz, curr_time, new_time)) {
+        return lwdtcOK;
+    }
+
+    /* Go to next second, ignore current actual time */
+    ++curr_time;
+    prv_get_localtime(cache->tz, &tm_time, &curr_time);
+    while ((step = prv_get_step(&tm_time, cron_ctx)) != PRV_STEP_NONE || prv_excl_is_set(cache->excl, &tm_time)) {
+        /* Match on excluded day skips to the next eligible day */
+        ASSERT_ACTION(prv_do_step(step != PRV_STEP_NONE ? step : PRV_STEP_DAY, cron_ctx, cache, &curr_time, &tm_time));
+    }
+    *new_time = curr_time;
+    return lwdtcOK;
+}
+
+/**
+ * \brief           Reset day cache, to be rebuilt on next use
+ * \param[out]      cache: Day cache object
+ * \return          \ref lwdtcOK on success, member of \ref lwdtcr_t otherwise 
+ */
+lwdtcr_t
+lwdtc_cron_daycache_reset(lwdtc_cron_daycache_t* cache) {
+    ASSERT_PARAM(cache != NULL);
+
+    LWDTC_MEMSET(cache, 0x00, sizeof(*cache));
+    return lwdtcOK;
+}
+
+/**
+ * \brief           Set exclusion calendar to the day cache.
+ *                  Next time search with the cache never returns time on excluded day
+ * 
+ * Cache is rebuilt on next use. Call the function again when calendar is modified,
+ * and after the cache has been reset.
+ * 
+ * \param[in,out]   cache: Day cache object
+ * \param[in]       excl: Exclusion calendar. Set to `NULL` to remove it
+ * \return          \ref lwdtcOK on success, member of \ref lwdtcr_t otherwise 
+ */
+lwdtcr_t
+lwdtc_cron_daycache_set_excl(lwdtc_cron_daycache_t* cache, const lwdtc_excl_t* excl) {
+    ASSERT_PARAM(cache != NULL);
+
+    cache->excl = excl;
+    cache->ctx = NULL;
+    return lwdtcOK;
+}
+
+/**
+ * \brief           Set time zone to the day cache.
+ *                  Next time search with the cache uses local time of the zone
+ * 
+ * Cache is rebuilt on next use. Call the function again after the cache has been reset.
+ * 
+ * \param[in,out]   cache: Day cache object
+ * \param[in]       tz: Time zone. Set to `NULL` to use \ref LWDTC_CFG_GET_LOCALTIME
+ * \return          \ref lwdtcOK on success, member of \ref lwdtcr_t otherwise 
+ */
+lwdtcr_t
+lwdtc_cron_daycache_set_tz(lwdtc_cron_daycache_t* cache, const lwdtc_tz_t* tz) {
+    ASSERT_PARAM(cache != NULL);
+
+    cache->tz = tz;
+    cache->ctx = NULL;
+    return lwdtcOK;
+}
+
+/**
+ * \brief           Get next time of fire for specific cron object, using memoized last result
+ * 
+ * Memo stores last query and its result. Cron does not fire in-between,
+ * so repeated or increasing queries before the last result return immediately.
+ * Queries outside the interval run regular search and update the memo.
+ * 
+ * Memo must be reset with \ref lwdtc_cron_memo_reset before first use,
+ * after the context is parsed again, or when local timezone changes.
+ * 
+ * \param           cron_ctx: CRON context object
+ * \param[in,out]   memo: Memo object, dedicated to the context
+ * \param           curr_time: Current time, used as reference to get new time
+ * \param[out]      new_time: Pointer to new time value
+ * \return          \ref lwdtcOK on success, \ref lwdtcERR if cron never fires in supported year range,
+ *                      member of \ref lwdtcr_t otherwise 
+ */
+lwdtcr_t
+lwdtc_cron_next_memo(const lwdtc_cron_ctx_t* cron_ctx, lwdtc_cron_memo_t* memo, time_t curr_time, time_t* new_time) {
+    ASSERT_PARAM(cron_ctx != NULL && memo != NULL);
+    ASSERT_PARAM(new_time != NULL);
+
+    /* Query within proven empty interval, or after the last query when cron does not fire anymore */
+    if (memo->ctx == cron_ctx && curr_time >= memo->query
+        && (memo->res != lwdtcOK || curr_time < memo->result)) {
+        *new_time = memo->result;
+        return memo->res;
+    }
+
+    /* Day cache is kept for the same context, exclusion calendar and time zone are always kept */
+    if (memo->ctx != cron_ctx) {
+        memo->cache.ctx = NULL;
+    }
+    memo->ctx = cron_ctx;
+    memo->query = curr_time;
+    memo->result = curr_time;
+    memo->res = lwdtc_cron_next_with_cache(cron_ctx, &memo->cache, curr_time, &memo->result);
+    *new_time = memo->result;
+    return memo->res;
+}
+
+/**
+ * \brief           Reset memo, to forget last result and day cache
+ * \param[out]      memo: Memo object
+ * \return          \ref lwdtcOK on success, member of \ref lwdtcr_t otherwise 
+ */
+lwdtcr_t
+lwdtc_cron_memo_reset(lwdtc_cron_memo_t* memo) {
+    ASSERT_PARAM(memo != NULL);
+
+    LWDTC_MEMSET(memo, 0x00, sizeof(*memo));
+    return lwdtcOK;
+}
+
+/**
+ * \brief           Count fire times of interval shape with closed-form calculation
+ * 
+ * Pattern of interval shape repeats every minute, when minutes field is a wildcard,
+ * or every hour otherwise. Hourly pattern requires position in the hour to be the same during whole interval,
+ * which is checked once per day. Generic search is used when local time offset changes
+ * by other than whole hours, such as `30` minutes daylight saving shift on Lord Howe Island.
+ * 
+ * \param[in]       cron_ctx: Cron context object with prepared flags
+ * \param[in]       t_from: Start of the interval, not included
+ * \param[in]       t_to: End of the interval, included
+ * \param[out]      count: Pointer to output number of fire times in the interval
+ * \return          `1` if count has been calculated, `0` if generic search must be used
+ */
+static uint8_t
+prv_shape_count(const lwdtc_cron_ctx_t* cron_ctx, time_t t_from, time_t t_to, size_t* count) {
+    struct tm tm_time;
+    int64_t pos[2] = {(int64_t)t_from, (int64_t)t_to}, cnt[2], offset = 0;
+    uint32_t period = 60, sec_cnt = PRV_SEC_COUNT(cron_ctx, LWDTC_SEC_MAX + 1);
+
+    if (PRV_FLAG_SHAPE_GET(cron_ctx->flags) != PRV_SHAPE_INTERVAL || t_to <= t_from || !PRV_TIME_IN_RANGE(t_from)
+        || !PRV_TIME_IN_RANGE(t_to)) {
+        return 0;
+    }
+
+    /* Position in the hour is the same at every day and at the end of the interval */
+    if (!(cron_ctx->flags & PRV_FLAG_WILDCARD(PRV_FIELD_MIN))) {
+        period = 3600;
+        for (int64_t time_pos = pos[0];; time_pos += 86400) {
+            time_t time = (time_t)(time_pos < pos[1] ? time_pos : pos[1]);
+            int64_t off;
+
+            LWDTC_CFG_GET_LOCALTIME(&tm_time, &time);
+            off = ((tm_time.tm_min * 60 + tm_time.tm_sec) - (int64_t)time % 3600 + 3600) % 3600;
+            if (time_pos > pos[0] && off != offset) {
+                return 0;
+            }
+            offset = off;
+            if (time_pos >= pos[1]) {
+                break;
+            }
+        }
+    }
+
+    /* Number of fire times from the epoch up to, and including, each end */
+    for (size_t i = 0; i < 2; ++i) {
+        uint32_t rem = (uint32_t)((pos[i] + offset) % period), min = rem / 60;
+
+        cnt[i] = (pos[i] + offset) / period;
+        if (period == 60) {
+            cnt[i] = cnt[i] * sec_cnt + PRV_SEC_COUNT(cron_ctx, rem + 1);
+        } else {
+            cnt[i] = cnt[i] * prv_count_bits(cron_ctx->min, LWDTC_MIN_MAX + 1) * sec_cnt
+                     + prv_count_bits(cron_ctx->min, min) * sec_cnt
+                     + (BIT_IS_SET(cron_ctx->min, min) ? PRV_SEC_COUNT(cron_ctx, rem % 60 + 1) : 0);
+        }
+    }
+    *count = (size_t)(cnt[1] - cnt[0]);
+    return 1;
+}
+
+/**
+ * \brief           Count number of fire times of the cron in the time interval
+ * 
+ * Search jumps from one matching minute to the next one,
+ * and counts valid seconds of the whole minute at once.
+ * Interval schedules, such as every 5 seconds, are counted directly, without the search.
+ * Local time offset is assumed to be multiple of a minute.
+ * 
+ * \param           cron_ctx: CRON context object
+ * \param           t_from: Start of the interval, not included
+ * \param           t_to: End of the interval, included
+ * \param[out]      count: Pointer to output number of fire times in the interval
+ * \return          \ref lwdtcOK on success, member of \ref lwdtcr_t otherwise 
+ */
+lwdtcr_t
+lwdtc_cron_count(const lwdtc_cron_ctx_t* cron_ctx, time_t t_from, time_t t_to, size_t* count) {
+    lwdtc_cron_daycache_t cache;
+    time_t time = t_from, min_start;
+    uint32_t sec_from, sec_to;
+    size_t cnt = 0;
+
+    ASSERT_PARAM(cron_ctx != NULL && count != NULL);
+
+    if (prv_shape_count(cron_ctx, t_from, t_to, count)) {
+        return lwdtcOK;
+    }
+    LWDTC_MEMSET(&cache, 0x00, sizeof(cache));
+    while (time < t_to && lwdtc_cron_next_with_cache(cron_ctx, &cache, time, &time) == lwdtcOK && time <= t_to) {
+        /* Cron is valid for the rest of the minute, where seconds field matches */
+        min_start = time - (time % 60);
+        sec_from = (uint32_t)(time - min_start);
+        sec_to = (uint32_t)(t_to - min_start < LWDTC_SEC_MAX ? t_to - min_start : LWDTC_SEC_MAX);
+        for (uint32_t sec = sec_from; sec <= sec_to; ++sec) {
+            cnt += PRV_SEC_IS_SET(cron_ctx, sec) ? 1 : 0;
+        }
+        time = min_start + LWDTC_SEC_MAX;
+    }
+    *count = cnt;
+    return lwdtcOK;
+}
+
+/**
+ * \brief           Find first time of day, when hour, minute and second fields all match
+ * \param[in]       cron_ctx: Cron context object with valid structure
+ * \param[in]       sod_from: First second of the day to check
+ * \param[in]       sod_to: Last second of the day to check
+ * \return          Matching second of the day, `UINT32_MAX` if there is none in the range
+ */
+static uint32_t
+prv_first_in_day(const lwdtc_cron_ctx_t* cron_ctx, uint32_t sod_from, uint32_t sod_to) {
+    uint32_t hour = sod_from / 3600U, min = (sod_from / 60U) % 60U, sec = sod_from % 60U, next;
+
+    while (hour <= sod_to / 3600U) {
+        /* Each field moves to its next valid value, lower fields restart when higher field moves */
+        if ((next = prv_next_bit(cron_ctx->hour, hour, LWDTC_HOUR_MAX)) != hour) {
+            hour = next, min = 0, sec = 0;
+            continue;
+        }
+        if ((next = prv_next_bit(cron_ctx->min, min, LWDTC_MIN_MAX)) != min) {
+            if (next > LWDTC_MIN_MAX) {
+                ++hour, min = 0, sec = 0;
+            } else {
+                min = next, sec = 0;
+            }
+            continue;
+        }
+        if ((next = PRV_SEC_NEXT(cron_ctx, sec)) > LWDTC_SEC_MAX) {
+            /* Minute overflow carries to the hour, before any bit-map is checked with it */
+            if (++min > LWDTC_MIN_MAX) {
+                ++hour, min = 0;
+            }
+            sec = 0;
+            continue;
+        }
+        next += hour * 3600U + min * 60U;
+        return next <= sod_to ? next : UINT32_MAX;
+    }
+    return UINT32_MAX;
+}
+
+/**
+ * \brief           Check if cron fired in the time interval, for example since the last check of the polling loop
+ * 
+ * When the interval is within one local day, it is checked with day-level fields
+ * and bit-maps of hour, minute and second fields, with two local time conversions only.
+ * Poller that stalls for a few seconds does not lose any fire time.
+ * Longer intervals use next time search.
+ * 
+ * \param[in]       cron_ctx: Cron context object with valid structure
+ * \param[in]       t_from: Start of the interval, not included. Typically time of the last check
+ * \param[in]       t_to: End of the interval, included. Typically current time
+ * \param[out]      first_hit: Optional pointer to output first fire time in the interval.
+ *                      Set to `NULL` if not used
+ * \return          \ref lwdtcOK if cron fired in the interval, \ref lwdtcERR if it did not,
+ *                      member of \ref lwdtcr_t otherwise
+ */
+lwdtcr_t
+lwdtc_cron_fired_between(const lwdtc_cron_ctx_t* cron_ctx, time_t t_from, time_t t_to, time_t* first_hit) {
+    struct tm tm_from, tm_to;
+    time_t time = t_from + 1;
+    uint32_t sod_from, sod_to, sod;
+
+    ASSERT_PARAM(cron_ctx != NULL);
+    ASSERT_ACTION(t_to > t_from);
+
+    /* Interval within one day, without local time offset change */
+    LWDTC_CFG_GET_LOCALTIME(&tm_from, &time);
+    LWDTC_CFG_GET_LOCALTIME(&tm_to, &t_to);
+    sod_from = (uint32_t)(tm_from.tm_hour * 3600 + tm_from.tm_min * 60 + tm_from.tm_sec);
+    sod_to = (uint32_t)(tm_to.tm_hour * 3600 + tm_to.tm_min * 60 + tm_to.tm_sec);
+    if (tm_from.tm_mday == tm_to.tm_mday && tm_from.tm_mon == tm_to.tm_mon && sod_to >= sod_from
+        && (time_t)(sod_to - sod_from) == t_to - time) {
+        ASSERT_ACTION(prv_is_day_valid(cron_ctx, (uint32_t)(tm_from.tm_year - 100), (uint32_t)(tm_from.tm_mon + 1),
+                                       (uint32_t)tm_from.tm_mday, (uint32_t)tm_from.tm_wday));
+        ASSERT_ACTION((sod = prv_first_in_day(cron_ctx, sod_from, sod_to)) != UINT32_MAX);
+        time += (time_t)(sod - sod_from);
+    } else {
+        ASSERT_ACTION(lwdtc_cron_next(cron_ctx, t_from, &time) == lwdtcOK && time <= t_to);
+    }
+    if (first_hit != NULL) {
+        *first_hit = time;
+    }
+    return lwdtcOK;
+}
+
+/* Get context at index, in array of contexts or array of structures with context */
+#define PRV_CTX_AT(base, stride, i) ((const lwdtc_cron_ctx_t*)((const uint8_t*)(base) + (i) * (stride)))
+
+/**
+ * \brief           Get earliest next time of fire among multiple cron objects in the same time zone
+ * \param[in]       cron_ctx: Pointer to the first context
+ * \param[in]       stride: Distance between the contexts in units of bytes
+ * \param[in]       ctx_len: Number of contexts
+ * \param[in]       tz: Time zone, `NULL` for \ref LWDTC_CFG_GET_LOCALTIME
+ * \param[in]       curr_time: Current time, used as reference to get new time
+ * \param[out]      new_time: Pointer to new time value, earliest of all contexts
+ * \param[out]      ctx_index: Optional pointer to output index of context that fires at `new_time`
+ * \return          \ref lwdtcOK on success, \ref lwdtcERR if no cron fires in supported year range
+ */
+static lwdtcr_t
+prv_next_multi(const lwdtc_cron_ctx_t* cron_ctx, size_t stride, size_t ctx_len, const lwdtc_tz_t* tz,
+               time_t curr_time, time_t* new_time, size_t* ctx_index) {
+    lwdtc_cron_ctx_t ctx_or;
+    lwdtc_cron_daycache_t cache;
+    struct tm tm_time;
+    uint8_t step, step_ctx;
+    size_t idx = 0;
+
+    /* Build context with union of all fields, used for fast common skip */
+    LWDTC_MEMSET(&ctx_or, 0x00, sizeof(ctx_or));
+    LWDTC_MEMSET(&cache, 0x00, sizeof(cache));
+    cache.tz = tz;
+    for (size_t i = 0; i < ctx_len; ++i) {
+#if LWDTC_CFG_FIELD_SEC
+        BIT_MAP_OR(ctx_or.sec, PRV_CTX_AT(cron_ctx, stride, i)->sec);
+#endif /* LWDTC_CFG_FIELD_SEC */
+        BIT_MAP_OR(ctx_or.min, PRV_CTX_AT(cron_ctx, stride, i)->min);
+        BIT_MAP_OR(ctx_or.hour, PRV_CTX_AT(cron_ctx, stride, i)->hour);
+        BIT_MAP_OR(ctx_or.mday, PRV_CTX_AT(cron_ctx, stride, i)->mday);
+        BIT_MAP_OR(ctx_or.mon, PRV_CTX_AT(cron_ctx, stride, i)->mon);
+        BIT_MAP_OR(ctx_or.wday, PRV_CTX_AT(cron_ctx, stride, i)->wday);
+#if LWDTC_CFG_FIELD_YEAR
+        BIT_MAP_OR(ctx_or.year, PRV_CTX_AT(cron_ctx, stride, i)->year);
+#endif /* LWDTC_CFG_FIELD_YEAR */
+    }
+
+    /* Go to next second, ignore current actual time */
+    ++curr_time;
+    prv_get_localtime(tz, &tm_time, &curr_time);
+    while (1) {
+        step = prv_get_step(&tm_time, &ctx_or);
+        if (step == PRV_STEP_NONE) {
+            /*
+             * At least one of the contexts may match current time.
+             *
+             * Check them all, and use the smallest step of all the contexts,
+             * to not skip any potential match
+             */
+            step = PRV_STEP_DAY;
+            for (idx = 0; idx < ctx_len; ++idx) {
+                step_ctx = prv_get_step(&tm_time, PRV_CTX_AT(cron_ctx, stride, idx));
+                if (step_ctx < step) {
+                    step = step_ctx;
+                    if (step == PRV_STEP_NONE) {
+                        break;
+                    }
+                }
+            }
+            if (step == PRV_STEP_NONE) {
+                break;
+            }
+        }
+
+        /* Day step uses union of all contexts, that may still be eligible on the next days */
+        ASSERT_ACTION(prv_do_step(step, &ctx_or, &cache, &curr_time, &tm_time));
+    }
+    *new_time = curr_time;
+    if (ctx_index != NULL) {
+        *ctx_index = idx;
+    }
+    return lwdtcOK;
+}
+
+/**
+ * \brief           Get earliest next time of fire among multiple cron objects
+ * 
+ * All contexts are searched together, sharing single local time conversion per step.
+ * Field bit-maps of all contexts are first OR-ed together,
+ * to quickly skip times that no context can match.
+ * 
+ * \param[in]       cron_ctx: Pointer to array of cron ctx objects
+ * \param[in]       ctx_len: Number of context array length
+ * \param[in]       curr_time: Current time, used as reference to get new time
+ * \param[out]      new_time: Pointer to new time value, earliest of all contexts
+ * \param[out]      ctx_index: Optional pointer to output variable to store array index of context
+ *                      that fires at `new_time`. When several contexts fire at the same time,
+ *                      the lowest index is used. Set to `NULL` if not used
+ * \return          \ref lwdtcOK on success, \ref lwdtcERR if no cron fires in supported year range,
+ *                      member of \ref lwdtcr_t otherwise 
+ */
+lwdtcr_t
+lwdtc_cron_next_multi(const lwdtc_cron_ctx_t* cron_ctx, size_t ctx_len, time_t curr_time, time_t* new_time,
+                      size_t* ctx_index) {
+    ASSERT_PARAM(cron_ctx != NULL && ctx_len > 0);
+    ASSERT_PARAM(new_time != NULL);
+
+    return prv_next_multi(cron_ctx, sizeof(*cron_ctx), ctx_len, NULL, curr_time, new_time, ctx_index);
+}
+
+/**
+ * \brief           Check if current time fits to at least one of provided context arrays (OR operation)
+ * \param[in]       tm_time: Current time to check if cron works for it.
+ *                      Function assumes values in the structure are within valid boundaries
+ *                      and does not perform additional check
+ * \param[in]       cron_ctx: Pointer to array of cron ctx objects
+ * \param[in]       ctx_len: Number of context array length
+ * \return          \ref lwdtcOK on success, member of \ref lwdtcr_t otherwise 
+ */
+lwdtcr_t
+lwdtc_cron_is_valid_for_time_multi_or(const struct tm* tm_time, const lwdtc_cron_ctx_t* cron_ctx, size_t ctx_len) {
+    lwdtcr_t res = lwdtcERR;
+
+    ASSERT_PARAM(cron_ctx != NULL && tm_time != NULL && ctx_len > 0);
+
+    /* Multi-cron context version of lwdtc_cron_is_valid_for_time */
+    while (ctx_len-- > 0) {
+        res = lwdtc_cron_is_valid_for_time(tm_time, cron_ctx++);
+        if (res == lwdtcOK) {
+            break;
+        }
+    }
+    return res;
 }
 
 /**
@@ -538,17 +2030,939 @@ lwdtc_cron_is_valid_for_time_multi_or(const struct tm* tm_time, const lwdtc_cron
  * \return          \ref lwdtcOK on success, member of \ref lwdtcr_t otherwise 
  */
 lwdtcr_t
-lwdtc_cron_is_valid_for_time_multi_and(const struct tm* tm_time, const lwdtc_cron_ctx_t* cron_ctx, size_t ctx_len) {
-    lwdtcr_t res = lwdtcERR;
+lwdtc_cron_is_valid_for_time_multi_and(const struct tm* tm_time, const lwdtc_cron_ctx_t* cron_ctx, size_t ctx_len) {
+    lwdtcr_t res = lwdtcERR;
+
+    ASSERT_PARAM(cron_ctx != NULL && tm_time != NULL && ctx_len > 0);
+
+    /* Multi-cron context version of lwdtc_cron_is_valid_for_time */
+    while (ctx_len-- > 0) {
+        res = lwdtc_cron_is_valid_for_time(tm_time, cron_ctx++);
+        if (res != lwdtcOK) {
+            break;
+        }
+    }
+    return res;
+}
+
+/**
+ * \brief           Check if cron is valid at specific time, and the day is not excluded by the calendar
+ * \param[in]       tm_time: Local time to check
+ * \param[in]       cron_ctx: Cron context object with valid structure
+ * \param[in]       excl: Exclusion calendar. When `NULL`, function is the same as \ref lwdtc_cron_is_valid_for_time
+ * \return          \ref lwdtcOK if CRON should execute, \ref lwdtcERR if it should not,
+ *                      member of \ref lwdtcr_t otherwise
+ */
+lwdtcr_t
+lwdtc_cron_is_valid_for_time_excl(const struct tm* tm_time, const lwdtc_cron_ctx_t* cron_ctx,
+                                  const lwdtc_excl_t* excl) {
+    ASSERT_PARAM(cron_ctx != NULL && tm_time != NULL);
+
+    if (prv_excl_is_set(excl, tm_time)) {
+        return lwdtcERR;
+    }
+    return lwdtc_cron_is_valid_for_time(tm_time, cron_ctx);
+}
+
+/* Day states for batch timestamp matching */
+#define PRV_DAY_UNUSED    0x00 /*!< Entry is not used yet */
+#define PRV_DAY_VALID     0x01 /*!< Regular day, day-level fields match */
+#define PRV_DAY_INVALID   0x02 /*!< Regular day, day-level fields do not match */
+#define PRV_DAY_IRREGULAR 0x03 /*!< Local time offset changes during the day */
+#define PRV_DAY_PENDING   0x04 /*!< Day has been seen once, edges are not checked yet */
+#define PRV_DAY_CACHE_LEN 16   /*!< Number of days kept in the cache */
+
+/**
+ * \brief           Day entry for batch timestamp matching
+ */
+typedef struct {
+    time_t start;  /*!< Time of local midnight, assuming regular day */
+    uint32_t year; /*!< Year offset from year `2000` */
+    uint8_t mon;   /*!< Month, `1` to `12` */
+    uint8_t mday;  /*!< Day in a month, `1` to `31` */
+    uint8_t wday;  /*!< Day in a week, `0` (Sunday) to `6` (Saturday) */
+    uint8_t state; /*!< Day state, one of `PRV_DAY_*` values */
+} prv_match_day_t;
+
+/**
+ * \brief           Set pending day entry for the day of converted time
+ * \param[out]      day: Day entry to set
+ * \param[in]       tm_time: Local time of `time`
+ * \param[in]       time: Time within the day
+ */
+static void
+prv_match_day_set(prv_match_day_t* day, const struct tm* tm_time, time_t time) {
+    day->start = time - (tm_time->tm_hour * 3600 + tm_time->tm_min * 60 + tm_time->tm_sec);
+    day->year = (uint32_t)(tm_time->tm_year - 100);
+    day->mon = (uint8_t)(tm_time->tm_mon + 1);
+    day->mday = (uint8_t)tm_time->tm_mday;
+    day->wday = (uint8_t)tm_time->tm_wday;
+    day->state = PRV_DAY_PENDING;
+}
+
+/**
+ * \brief           Check pending day entry, when the day is used the second time
+ * 
+ * Day is regular when local midnight and last second of the day are both exactly `86400` seconds apart,
+ * so any time of the day can be converted to hours, minutes and seconds with arithmetic only
+ * 
+ * \param[in]       cron_ctx: Cron context object with valid structure
+ * \param[in,out]   day: Pending day entry
+ */
+static void
+prv_match_day_check(const lwdtc_cron_ctx_t* cron_ctx, prv_match_day_t* day) {
+    struct tm tm_edge;
+    time_t edge;
+
+    day->state = PRV_DAY_IRREGULAR;
+
+    /* Check both edges of the day */
+    edge = day->start;
+    LWDTC_CFG_GET_LOCALTIME(&tm_edge, &edge);
+    if (tm_edge.tm_mday != day->mday || tm_edge.tm_hour != 0 || tm_edge.tm_min != 0 || tm_edge.tm_sec != 0) {
+        return;
+    }
+    edge = day->start + 86399;
+    LWDTC_CFG_GET_LOCALTIME(&tm_edge, &edge);
+    if (tm_edge.tm_mday != day->mday || tm_edge.tm_hour != 23 || tm_edge.tm_min != 59 || tm_edge.tm_sec != 59) {
+        return;
+    }
+    day->state = prv_is_day_valid(cron_ctx, day->year, day->mon, day->mday, day->wday) ? PRV_DAY_VALID
+                                                                                         : PRV_DAY_INVALID;
+}
+
+/**
+ * \brief           Check array of timestamps against the cron and write match bit-map
+ * 
+ * Local time is converted only a few times per day.
+ * Day-level fields are checked once per day, and time of day is calculated with arithmetic only.
+ * Timestamps may be sorted or unsorted, recently used days are kept in small cache.
+ * First timestamp of the day is checked with its local time conversion,
+ * and both edges of the day are converted when the day is used again.
+ * Days when local time offset changes use regular local time conversion for every timestamp.
+ * 
+ * Sorted timestamps need at most three conversions per day.
+ * Worst case are unsorted timestamps spread over more than `16` days, that miss the cache,
+ * with one conversion per timestamp, as with \ref lwdtc_cron_is_valid_for_time for every timestamp.
+ * 
+ * Time of day fields are extracted in scalar loop, without vector instructions, to keep the library portable.
+ * Extraction is one subtraction and divisions by constants, followed by bit-map lookups, that do not vectorize,
+ * while the dominant cost, local time conversion, is already done once per day
+ * 
+ * \param[in]       cron_ctx: Cron context object with valid structure
+ * \param[in]       ts: Array of timestamps to check
+ * \param[in]       n: Number of timestamps
+ * \param[out]      out_bits: Output bit-map, at least `(n + 7) / 8` bytes long.
+ *                      Bit `i` (bit `i % 8` of byte `i / 8`) is set when cron is valid at timestamp `ts[i]`
+ * \return          \ref lwdtcOK on success, member of \ref lwdtcr_t otherwise
+ */
+lwdtcr_t
+lwdtc_cron_match_timestamps(const lwdtc_cron_ctx_t* cron_ctx, const time_t* ts, size_t n, uint8_t* out_bits) {
+    prv_match_day_t days[PRV_DAY_CACHE_LEN];
+    struct tm tm_time;
+
+    ASSERT_PARAM(cron_ctx != NULL && (n == 0 || (ts != NULL && out_bits != NULL)));
+
+    LWDTC_MEMSET(days, 0x00, sizeof(days));
+    LWDTC_MEMSET(out_bits, 0x00, (n + 7) / 8);
+    for (size_t i = 0; i < n; ++i) {
+        prv_match_day_t* day = &days[(size_t)((uint64_t)(ts[i] / 86400) % PRV_DAY_CACHE_LEN)];
+        uint32_t sod;
+
+        if (day->state == PRV_DAY_UNUSED || ts[i] < day->start || ts[i] - day->start >= 86400) {
+            /* New day, timestamp is checked with its conversion */
+            LWDTC_CFG_GET_LOCALTIME(&tm_time, &ts[i]);
+            prv_match_day_set(day, &tm_time, ts[i]);
+            if (lwdtc_cron_is_valid_for_time(&tm_time, cron_ctx) == lwdtcOK) {
+                BIT_SET(out_bits, i);
+            }
+            continue;
+        }
+        if (day->state == PRV_DAY_PENDING) {
+            prv_match_day_check(cron_ctx, day);
+        }
+        if (day->state == PRV_DAY_VALID) {
+            sod = (uint32_t)(ts[i] - day->start);
+            if (BIT_IS_SET(cron_ctx->hour, sod / 3600U) && BIT_IS_SET(cron_ctx->min, (sod / 60U) % 60U)
+                && PRV_SEC_IS_SET(cron_ctx, sod % 60U)) {
+                BIT_SET(out_bits, i);
+            }
+        } else if (day->state == PRV_DAY_IRREGULAR) {
+            LWDTC_CFG_GET_LOCALTIME(&tm_time, &ts[i]);
+            if (lwdtc_cron_is_valid_for_time(&tm_time, cron_ctx) == lwdtcOK) {
+                BIT_SET(out_bits, i);
+            }
+        }
+    }
+    return lwdtcOK;
+}
+
+/* Get fields from packed date and time values, without any conversion */
+#define PRV_DT32_YEAR(dt) ((uint32_t)(dt) >> 25U)              /*!< Year offset from 1980 */
+#define PRV_DT32_MON(dt)  (((uint32_t)(dt) >> 21U) & 0x0FU)
+#define PRV_DT32_MDAY(dt) (((uint32_t)(dt) >> 16U) & 0x1FU)
+#define PRV_DT32_HOUR(dt) (((uint32_t)(dt) >> 11U) & 0x1FU)
+#define PRV_DT32_MIN(dt)  (((uint32_t)(dt) >> 5U) & 0x3FU)
+#define PRV_DT32_SEC2(dt) ((uint32_t)(dt) & 0x1FU)             /*!< Seconds divided by 2 */
+#define PRV_DT64_YEAR(dt) ((uint32_t)((dt) >> 48U))
+#define PRV_DT64_BYTE(dt, n) ((uint32_t)((dt) >> (8U * (n))) & 0xFFU)
+
+/* BCD register to binary value and back. Tens digit counts 16 instead of 10 */
+#define PRV_BCD_TO_BIN(b) ((uint32_t)(b) - 6U * ((uint32_t)(b) >> 4U))
+#define PRV_BIN_TO_BCD(v) ((uint8_t)((v) + 6U * ((v) / 10U)))
+
+/* Calendar repeats after 400 years, next time search never looks further */
+#define PRV_NEXT_YEARS 400
+
+/**
+ * \brief           Broken-down date and time for next time search on packed values
+ */
+typedef struct {
+    int32_t year;  /*!< Full year number */
+    uint32_t mon;  /*!< Month, `1` to `12` */
+    uint32_t mday; /*!< Day in month, `1` to `31` */
+    uint32_t hour; /*!< Hours */
+    uint32_t min;  /*!< Minutes */
+    uint32_t sec;  /*!< Seconds */
+    uint32_t wday; /*!< Week day, set by the search */
+} prv_dt_t;
+
+/**
+ * \brief           Get week day of the date, with arithmetic only
+ * \param[in]       year: Full year number
+ * \param[in]       mon: Month, `1` to `12`
+ * \param[in]       mday: Day in a month, `1` to `31`
+ * \return          Week day, `0` (Sunday) to `6` (Saturday)
+ */
+static uint32_t
+prv_get_wday(int32_t year, uint32_t mon, uint32_t mday) {
+    int32_t days = prv_days_from_civil(year, mon, mday);
+
+    return (uint32_t)((days % 7 + 11) % 7); /* 1970-01-01 was Thursday */
+}
+
+/**
+ * \brief           Check if cron is active at date and time, packed to \ref lwdtc_dt32_t value
+ * 
+ * Fields are tested directly from the packed value, without conversion to broken-down time.
+ * Value stands for 2 seconds interval, and cron is valid when it is valid at any second of the interval.
+ * Week day is calculated from the date, only when day-level fields need it.
+ * 
+ * \param[in]       dt: Date and time to check. Function assumes fields are within valid boundaries
+ * \param[in]       cron_ctx: Cron context object with valid structure
+ * \return          \ref lwdtcOK on success, member of \ref lwdtcr_t otherwise
+ */
+lwdtcr_t
+lwdtc_cron_is_valid_for_dt32(lwdtc_dt32_t dt, const lwdtc_cron_ctx_t* cron_ctx) {
+    uint32_t year, mon, mday, wday = 0;
+
+    ASSERT_PARAM(cron_ctx != NULL);
+
+    if (!PRV_SEC2_IS_SET(cron_ctx, PRV_DT32_SEC2(dt)) || !BIT_IS_SET(cron_ctx->min, PRV_DT32_MIN(dt))
+        || !BIT_IS_SET(cron_ctx->hour, PRV_DT32_HOUR(dt))) {
+        return lwdtcERR;
+    }
+    year = PRV_DT32_YEAR(dt) - 20U; /* Offset from 2000, years before wrap to invalid value */
+    mon = PRV_DT32_MON(dt);
+    mday = PRV_DT32_MDAY(dt);
+    if (!(cron_ctx->flags & PRV_FLAG_PREPARED) || !(cron_ctx->flags & PRV_FLAG_WILDCARD(PRV_FIELD_WDAY))
+        || LWDTC_CFG_DAY_SPECIAL) {
+        wday = prv_get_wday((int32_t)(2000 + year), mon, mday);
+    }
+    return prv_is_day_valid(cron_ctx, year, mon, mday, wday) ? lwdtcOK : lwdtcERR;
+}
+
+/**
+ * \brief           Check if cron is active at date and time, packed to \ref lwdtc_dt64_t value
+ * 
+ * Fields, including week day, are tested directly from the packed value,
+ * without conversion to broken-down time.
+ * 
+ * \param[in]       dt: Date and time to check. Function assumes fields are within valid boundaries
+ * \param[in]       cron_ctx: Cron context object with valid structure
+ * \return          \ref lwdtcOK on success, member of \ref lwdtcr_t otherwise
+ */
+lwdtcr_t
+lwdtc_cron_is_valid_for_dt64(lwdtc_dt64_t dt, const lwdtc_cron_ctx_t* cron_ctx) {
+    ASSERT_PARAM(cron_ctx != NULL);
+
+    if (!PRV_SEC_IS_SET(cron_ctx, PRV_DT64_BYTE(dt, 1)) || !BIT_IS_SET(cron_ctx->min, PRV_DT64_BYTE(dt, 2))
+        || !BIT_IS_SET(cron_ctx->hour, PRV_DT64_BYTE(dt, 3))) {
+        return lwdtcERR;
+    }
+    return prv_is_day_valid(cron_ctx, PRV_DT64_YEAR(dt) - 2000U, PRV_DT64_BYTE(dt, 5), PRV_DT64_BYTE(dt, 4),
+                            PRV_DT64_BYTE(dt, 0))
+               ? lwdtcOK
+               : lwdtcERR;
+}
+
+/**
+ * \brief           Check if cron is active at date and time, read from RTC registers in BCD format
+ * 
+ * Every register is converted to bit position with one multiplication, without conversion to broken-down time.
+ * 
+ * \param[in]       bcd: Date and time to check. Function assumes fields are within valid boundaries
+ * \param[in]       cron_ctx: Cron context object with valid structure
+ * \return          \ref lwdtcOK on success, member of \ref lwdtcr_t otherwise
+ */
+lwdtcr_t
+lwdtc_cron_is_valid_for_bcd(const lwdtc_bcd_t* bcd, const lwdtc_cron_ctx_t* cron_ctx) {
+    ASSERT_PARAM(bcd != NULL && cron_ctx != NULL);
+
+    if (!PRV_SEC_IS_SET(cron_ctx, PRV_BCD_TO_BIN(bcd->sec & 0x7FU))
+        || !BIT_IS_SET(cron_ctx->min, PRV_BCD_TO_BIN(bcd->min & 0x7FU))
+        || !BIT_IS_SET(cron_ctx->hour, PRV_BCD_TO_BIN(bcd->hour & 0x3FU))) {
+        return lwdtcERR;
+    }
+    return prv_is_day_valid(cron_ctx, PRV_BCD_TO_BIN(bcd->year), PRV_BCD_TO_BIN(bcd->mon & 0x1FU),
+                            PRV_BCD_TO_BIN(bcd->mday & 0x3FU), (bcd->wday & 0x07U) % 7U)
+               ? lwdtcOK
+               : lwdtcERR;
+}
+
+/**
+ * \brief           Find first date and time, at or after the input, when cron is valid
+ * 
+ * Search runs on calendar fields, from year down to seconds, and never converts time.
+ * Field values above their maximum are accepted, and carry to the next higher field.
+ * 
+ * \param[in]       cron_ctx: Cron context object with valid structure
+ * \param[in,out]   dt: Date and time to start at, set to found date and time on success
+ * \param[in]       year_max: Last year to search, limited to \ref PRV_NEXT_YEARS years after the start
+ * \return          \ref lwdtcOK on success, \ref lwdtcERR if cron is not valid until the last year
+ */
+static lwdtcr_t
+prv_next_fields(const lwdtc_cron_ctx_t* cron_ctx, prv_dt_t* dt, int32_t year_max) {
+    uint32_t val, mdays;
+
+    if (year_max > dt->year + PRV_NEXT_YEARS) {
+        year_max = dt->year + PRV_NEXT_YEARS;
+    }
+    while (dt->year <= year_max) {
+        if (dt->mon > LWDTC_MON_MAX || !PRV_YEAR_IS_SET(cron_ctx, (uint32_t)(dt->year - 2000))) {
+            ++dt->year;
+            dt->mon = LWDTC_MON_MIN;
+            dt->mday = LWDTC_MDAY_MIN;
+            dt->hour = dt->min = dt->sec = 0;
+            continue;
+        }
+        if ((val = prv_next_bit(cron_ctx->mon, dt->mon, LWDTC_MON_MAX)) != dt->mon) {
+            dt->mon = val;
+            dt->mday = LWDTC_MDAY_MIN;
+            dt->hour = dt->min = dt->sec = 0;
+            continue;
+        }
+        mdays = lwdtci_get_month_days(dt->year, dt->mon);
+        if (dt->mday > mdays) {
+            ++dt->mon;
+            dt->mday = LWDTC_MDAY_MIN;
+            dt->hour = dt->min = dt->sec = 0;
+            continue;
+        }
+        dt->wday = prv_get_wday(dt->year, dt->mon, dt->mday);
+        if (!PRV_MDAY_IS_SET(cron_ctx, (uint32_t)(dt->year - 2000), dt->mon, dt->mday, dt->wday)
+            || !PRV_WDAY_IS_SET(cron_ctx, (uint32_t)(dt->year - 2000), dt->mon, dt->mday, dt->wday)) {
+            ++dt->mday;
+            dt->hour = dt->min = dt->sec = 0;
+            continue;
+        }
+
+        /* Day is valid, find time of day. No valid time carries to the next day */
+        if ((val = prv_next_bit(cron_ctx->hour, dt->hour, LWDTC_HOUR_MAX)) > LWDTC_HOUR_MAX) {
+            ++dt->mday;
+            dt->hour = dt->min = dt->sec = 0;
+            continue;
+        } else if (val != dt->hour) {
+            dt->hour = val;
+            dt->min = dt->sec = 0;
+        }
+        if ((val = prv_next_bit(cron_ctx->min, dt->min, LWDTC_MIN_MAX)) > LWDTC_MIN_MAX) {
+            ++dt->hour;
+            dt->min = dt->sec = 0;
+            continue;
+        } else if (val != dt->min) {
+            dt->min = val;
+            dt->sec = 0;
+        }
+        if ((val = PRV_SEC_NEXT(cron_ctx, dt->sec)) > LWDTC_SEC_MAX) {
+            ++dt->min;
+            dt->sec = 0;
+            continue;
+        }
+        dt->sec = val;
+        return lwdtcOK;
+    }
+    return lwdtcERR;
+}
+
+/**
+ * \brief           Get next date and time of fire, packed to \ref lwdtc_dt32_t value
+ * 
+ * Search runs on calendar fields, without conversion to `time_t` or local time,
+ * and result is the first 2 seconds interval after the current one, when cron is valid.
+ * 
+ * \param[in]       cron_ctx: Cron context object with valid structure
+ * \param[in]       curr_dt: Current date and time
+ * \param[out]      new_dt: Pointer to next date and time of fire
+ * \return          \ref lwdtcOK on success, \ref lwdtcERR if cron never fires before year `2108`,
+ *                      member of \ref lwdtcr_t otherwise
+ */
+lwdtcr_t
+lwdtc_cron_next_dt32(const lwdtc_cron_ctx_t* cron_ctx, lwdtc_dt32_t curr_dt, lwdtc_dt32_t* new_dt) {
+    prv_dt_t dt;
+
+    ASSERT_PARAM(cron_ctx != NULL && new_dt != NULL);
+
+    dt.year = (int32_t)(1980 + PRV_DT32_YEAR(curr_dt));
+    dt.mon = PRV_DT32_MON(curr_dt);
+    dt.mday = PRV_DT32_MDAY(curr_dt);
+    dt.hour = PRV_DT32_HOUR(curr_dt);
+    dt.min = PRV_DT32_MIN(curr_dt);
+    dt.sec = 2U * PRV_DT32_SEC2(curr_dt) + 2U;
+    if (prv_next_fields(cron_ctx, &dt, 1980 + 127) != lwdtcOK) {
+        return lwdtcERR;
+    }
+    *new_dt = LWDTC_DT32(dt.year, dt.mon, dt.mday, dt.hour, dt.min, dt.sec);
+    return lwdtcOK;
+}
+
+/**
+ * \brief           Get next date and time of fire, packed to \ref lwdtc_dt64_t value
+ * 
+ * Search runs on calendar fields, without conversion to `time_t` or local time.
+ * 
+ * \param[in]       cron_ctx: Cron context object with valid structure
+ * \param[in]       curr_dt: Current date and time
+ * \param[out]      new_dt: Pointer to next date and time of fire, with its week day
+ * \return          \ref lwdtcOK on success, \ref lwdtcERR if cron never fires in supported year range,
+ *                      member of \ref lwdtcr_t otherwise
+ */
+lwdtcr_t
+lwdtc_cron_next_dt64(const lwdtc_cron_ctx_t* cron_ctx, lwdtc_dt64_t curr_dt, lwdtc_dt64_t* new_dt) {
+    prv_dt_t dt;
+
+    ASSERT_PARAM(cron_ctx != NULL && new_dt != NULL);
+
+    dt.year = (int32_t)PRV_DT64_YEAR(curr_dt);
+    dt.mon = PRV_DT64_BYTE(curr_dt, 5);
+    dt.mday = PRV_DT64_BYTE(curr_dt, 4);
+    dt.hour = PRV_DT64_BYTE(curr_dt, 3);
+    dt.min = PRV_DT64_BYTE(curr_dt, 2);
+    dt.sec = PRV_DT64_BYTE(curr_dt, 1) + 1U;
+    if (prv_next_fields(cron_ctx, &dt, 0xFFFF) != lwdtcOK) {
+        return lwdtcERR;
+    }
+    *new_dt = LWDTC_DT64(dt.year, dt.mon, dt.mday, dt.hour, dt.min, dt.sec, dt.wday);
+    return lwdtcOK;
+}
+
+/**
+ * \brief           Get next date and time of fire, as RTC registers in BCD format
+ * 
+ * Search runs on calendar fields, without conversion to `time_t` or local time.
+ * Result can be written to RTC alarm registers, or back to RTC time registers.
+ * 
+ * \param[in]       cron_ctx: Cron context object with valid structure
+ * \param[in]       curr_bcd: Current date and time
+ * \param[out]      new_bcd: Pointer to next date and time of fire, with week day `1` (Monday) to `7` (Sunday).
+ *                      Control bits are cleared
+ * \return          \ref lwdtcOK on success, \ref lwdtcERR if cron never fires before year `2100`,
+ *                      member of \ref lwdtcr_t otherwise
+ */
+lwdtcr_t
+lwdtc_cron_next_bcd(const lwdtc_cron_ctx_t* cron_ctx, const lwdtc_bcd_t* curr_bcd, lwdtc_bcd_t* new_bcd) {
+    prv_dt_t dt;
+
+    ASSERT_PARAM(cron_ctx != NULL && curr_bcd != NULL && new_bcd != NULL);
+
+    dt.year = (int32_t)(2000 + PRV_BCD_TO_BIN(curr_bcd->year));
+    dt.mon = PRV_BCD_TO_BIN(curr_bcd->mon & 0x1FU);
+    dt.mday = PRV_BCD_TO_BIN(curr_bcd->mday & 0x3FU);
+    dt.hour = PRV_BCD_TO_BIN(curr_bcd->hour & 0x3FU);
+    dt.min = PRV_BCD_TO_BIN(curr_bcd->min & 0x7FU);
+    dt.sec = PRV_BCD_TO_BIN(curr_bcd->sec & 0x7FU) + 1U;
+    if (prv_next_fields(cron_ctx, &dt, 2099) != lwdtcOK) {
+        return lwdtcERR;
+    }
+    new_bcd->sec = PRV_BIN_TO_BCD(dt.sec);
+    new_bcd->min = PRV_BIN_TO_BCD(dt.min);
+    new_bcd->hour = PRV_BIN_TO_BCD(dt.hour);
+    new_bcd->wday = (uint8_t)(dt.wday == 0 ? 7U : dt.wday);
+    new_bcd->mday = PRV_BIN_TO_BCD(dt.mday);
+    new_bcd->mon = PRV_BIN_TO_BCD(dt.mon);
+    new_bcd->year = PRV_BIN_TO_BCD((uint32_t)(dt.year - 2000));
+    return lwdtcOK;
+}
+
+/**
+ * \brief           Check if cron context can never be valid, because at least one field has no valid value
+ * \param[in]       cron_ctx: Cron context object with valid structure
+ * \return          `1` if empty, `0` otherwise
+ */
+static uint8_t
+prv_is_empty(const lwdtc_cron_ctx_t* cron_ctx) {
+    for (size_t f = 0; f < PRV_FIELD_NUM; ++f) {
+        const uint8_t* map = PRV_FIELD_MAP(cron_ctx, f);
+        uint8_t val = 0;
+
+        for (size_t i = 0; i < PRV_FIELD_SIZE(f); ++i) {
+            val |= map[i];
+        }
+        if (val == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * \brief           Get mask of fields that are different between two contexts
+ * \param[in]       ctx_a: First cron context
+ * \param[in]       ctx_b: Second cron context
+ * \return          Bit mask of different fields, bit position is `PRV_FIELD_*` value
+ */
+static uint32_t
+prv_get_diff_fields(const lwdtc_cron_ctx_t* ctx_a, const lwdtc_cron_ctx_t* ctx_b) {
+    uint32_t diff = 0;
+
+    for (size_t f = 0; f < PRV_FIELD_NUM; ++f) {
+        if (memcmp(PRV_FIELD_MAP(ctx_a, f), PRV_FIELD_MAP(ctx_b, f), PRV_FIELD_SIZE(f)) != 0) {
+            diff |= 1UL << f;
+        }
+    }
+    return diff;
+}
+
+/**
+ * \brief           Check if all fields of first context are subset of fields in second context
+ * \param[in]       ctx_a: First cron context
+ * \param[in]       ctx_b: Second cron context
+ * \return          `1` if subset, `0` otherwise
+ */
+static uint8_t
+prv_is_subset(const lwdtc_cron_ctx_t* ctx_a, const lwdtc_cron_ctx_t* ctx_b) {
+    if (prv_is_empty(ctx_a)) {
+        return 1;
+    }
+    for (size_t f = 0; f < PRV_FIELD_NUM; ++f) {
+        const uint8_t *map_a = PRV_FIELD_MAP(ctx_a, f), *map_b = PRV_FIELD_MAP(ctx_b, f);
+
+        for (size_t i = 0; i < PRV_FIELD_SIZE(f); ++i) {
+            if (map_a[i] & ~map_b[i]) {
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+/**
+ * \brief           Convert time to local time of the zone
+ * \param[in]       tz: Time zone. Set to `NULL` to use \ref LWDTC_CFG_GET_LOCALTIME
+ * \param[in]       time: Time to convert
+ * \param[out]      tm_time: Pointer to output broken-down local time
+ * \return          \ref lwdtcOK on success, member of \ref lwdtcr_t otherwise 
+ */
+lwdtcr_t
+lwdtc_tz_get_time(const lwdtc_tz_t* tz, time_t time, struct tm* tm_time) {
+    ASSERT_PARAM(tm_time != NULL);
+
+    prv_get_localtime(tz, tm_time, &time);
+    return lwdtcOK;
+}
+
+/**
+ * \brief           Check if time zones convert time the same way
+ * 
+ * Zones are the same when they are the same object, have the same fixed offset,
+ * or the same `get_time` function and argument
+ * 
+ * \param[in]       tz_a: First zone, `NULL` for \ref LWDTC_CFG_GET_LOCALTIME
+ * \param[in]       tz_b: Second zone, `NULL` for \ref LWDTC_CFG_GET_LOCALTIME
+ * \return          `1` if zones are the same, `0` otherwise
+ */
+static uint8_t
+prv_tz_is_same(const lwdtc_tz_t* tz_a, const lwdtc_tz_t* tz_b) {
+    if (tz_a == tz_b) {
+        return 1;
+    } else if (tz_a == NULL || tz_b == NULL || tz_a->get_time != tz_b->get_time) {
+        return 0;
+    }
+    return tz_a->get_time == NULL ? tz_a->utc_offset == tz_b->utc_offset : tz_a->arg == tz_b->arg;
+}
+
+/**
+ * \brief           Get sort key of the time zone
+ * 
+ * Process local time is first, then fixed offset zones by offset,
+ * then user function zones by their identifier
+ * 
+ * \param[in]       tz: Time zone, `NULL` for \ref LWDTC_CFG_GET_LOCALTIME
+ * \return          Sort key of the zone
+ */
+static int64_t
+prv_tz_key(const lwdtc_tz_t* tz) {
+    if (tz == NULL) {
+        return INT64_MIN;
+    } else if (tz->get_time == NULL) {
+        return tz->utc_offset;
+    }
+    return (int64_t)86400 + tz->id;
+}
+
+/**
+ * \brief           Sort table entries to group contexts of the same time zone together
+ * 
+ * Sort is done once, when table is built, before it is used with \ref lwdtc_cron_tz_table_match
+ * and \ref lwdtc_cron_tz_table_next functions. Zones are validated and ordered by their key:
+ * process local time first, then fixed offset zones by offset, then user function zones by identifier.
+ * Zones that convert time the same way, such as different objects with the same fixed offset,
+ * are grouped together, and time is converted once per group.
+ * Table that is not sorted gives the same results, with more time conversions.
+ * 
+ * Sort is stable, entries of the same zone keep their relative order.
+ * Application must update its own references to entries after the sort
+ * 
+ * \param[in,out]   entries: Pointer to array of table entries
+ * \param[in]       entries_len: Number of table entries
+ * \return          \ref lwdtcOK on success, \ref lwdtcERRPAR if fixed offset of any zone is not valid,
+ *                      member of \ref lwdtcr_t otherwise 
+ */
+lwdtcr_t
+lwdtc_cron_tz_table_sort(lwdtc_cron_tz_entry_t* entries, size_t entries_len) {
+    lwdtc_cron_tz_entry_t entry;
+    int64_t key;
+    size_t j;
+
+    ASSERT_PARAM(entries != NULL);
+    for (size_t i = 0; i < entries_len; ++i) {
+        const lwdtc_tz_t* tz = entries[i].tz;
+
+        ASSERT_PARAM(tz == NULL || tz->get_time != NULL
+                     || (tz->utc_offset % 60 == 0 && tz->utc_offset > -86400 && tz->utc_offset < 86400));
+    }
+
+    /* Tables are built once, insertion sort is enough */
+    for (size_t i = 1; i < entries_len; ++i) {
+        entry = entries[i];
+        key = prv_tz_key(entry.tz);
+        for (j = i; j > 0 && prv_tz_key(entries[j - 1].tz) > key; --j) {
+            entries[j] = entries[j - 1];
+        }
+        entries[j] = entry;
+    }
+    return lwdtcOK;
+}
+
+/**
+ * \brief           Check which table entries are valid at specific time, each in its own time zone
+ * 
+ * Time is converted only once for every group of consecutive entries with the same zone
+ * 
+ * \param[in]       entries: Pointer to array of table entries, sorted with \ref lwdtc_cron_tz_table_sort
+ * \param[in]       entries_len: Number of table entries
+ * \param[in]       time: Time to check
+ * \param[out]      out_bits: Pointer to output bit-map, with `(entries_len + 7) / 8` bytes.
+ *                      Bit `i` is set, when entry `i` is valid at the time
+ * \return          \ref lwdtcOK on success, member of \ref lwdtcr_t otherwise 
+ */
+lwdtcr_t
+lwdtc_cron_tz_table_match(const lwdtc_cron_tz_entry_t* entries, size_t entries_len, time_t time,
+                          uint8_t* out_bits) {
+    struct tm tm_time;
+
+    ASSERT_PARAM(entries != NULL && out_bits != NULL);
+
+    LWDTC_MEMSET(out_bits, 0x00, (entries_len + 7) / 8);
+    for (size_t i = 0; i < entries_len; ++i) {
+        if (i == 0 || !prv_tz_is_same(entries[i].tz, entries[i - 1].tz)) {
+            prv_get_localtime(entries[i].tz, &tm_time, &time);
+        }
+        if (lwdtc_cron_is_valid_for_time(&tm_time, &entries[i].ctx) == lwdtcOK) {
+            BIT_SET(out_bits, i);
+        }
+    }
+    return lwdtcOK;
+}
+
+/**
+ * \brief           Get earliest next time of fire among table entries, each in its own time zone
+ * 
+ * Every group of consecutive entries with the same zone is searched in single pass,
+ * as with \ref lwdtc_cron_next_multi function. Earliest time of all groups is returned
+ * 
+ * \param[in]       entries: Pointer to array of table entries, sorted with \ref lwdtc_cron_tz_table_sort
+ * \param[in]       entries_len: Number of table entries
+ * \param[in]       curr_time: Current time, used as reference to get new time
+ * \param[out]      new_time: Pointer to new time value, earliest of all entries
+ * \param[out]      entry_index: Optional pointer to output index of entry that fires at `new_time`.
+ *                      When multiple entries fire at the same time, the lowest index is used.
+ *                      Set to `NULL` if not used
+ * \return          \ref lwdtcOK on success, \ref lwdtcERR if no entry fires in supported year range,
+ *                      member of \ref lwdtcr_t otherwise 
+ */
+lwdtcr_t
+lwdtc_cron_tz_table_next(const lwdtc_cron_tz_entry_t* entries, size_t entries_len, time_t curr_time,
+                         time_t* new_time, size_t* entry_index) {
+    time_t best_time = 0, group_time;
+    size_t best_idx = 0, group_idx, end;
+    uint8_t found = 0;
+
+    ASSERT_PARAM(entries != NULL && entries_len > 0);
+    ASSERT_PARAM(new_time != NULL);
+
+    for (size_t start = 0; start < entries_len; start = end) {
+        for (end = start + 1; end < entries_len && prv_tz_is_same(entries[end].tz, entries[start].tz); ++end) {}
+        if (prv_next_multi(&entries[start].ctx, sizeof(*entries), end - start, entries[start].tz, curr_time,
+                           &group_time, &group_idx)
+                == lwdtcOK
+            && (!found || group_time < best_time)) {
+            best_time = group_time;
+            best_idx = start + group_idx;
+            found = 1;
+        }
+    }
+    ASSERT_ACTION(found);
+    *new_time = best_time;
+    if (entry_index != NULL) {
+        *entry_index = best_idx;
+    }
+    return lwdtcOK;
+}
+
+/**
+ * \brief           Build intersection of multiple cron contexts (AND operation)
+ * 
+ * New context is valid exactly at the times, when all input contexts are valid.
+ * It can replace the call to \ref lwdtc_cron_is_valid_for_time_multi_and
+ * with single call to \ref lwdtc_cron_is_valid_for_time
+ * 
+ * \note            Contexts with special day operators, `L`, `W` or `#`, cannot be intersected
+ *                      and function returns \ref lwdtcERR
+ * 
+ * \param[out]      out_ctx: Output cron context. It may point to one of the input contexts
+ * \param[in]       cron_ctx: Pointer to array of cron ctx objects
+ * \param[in]       ctx_len: Number of context array length
+ * \return          \ref lwdtcOK on success, member of \ref lwdtcr_t otherwise 
+ */
+lwdtcr_t
+lwdtc_cron_intersect(lwdtc_cron_ctx_t* out_ctx, const lwdtc_cron_ctx_t* cron_ctx, size_t ctx_len) {
+    lwdtc_cron_ctx_t ctx;
 
-    ASSERT_PARAM(cron_ctx != NULL && tm_time != NULL && ctx_len > 0);
+    ASSERT_PARAM(out_ctx != NULL && cron_ctx != NULL && ctx_len > 0);
+#if LWDTC_CFG_DAY_SPECIAL
+    for (size_t i = 0; i < ctx_len; ++i) {
+        ASSERT_ACTION(!prv_has_day_special(&cron_ctx[i]));
+    }
+#endif /* LWDTC_CFG_DAY_SPECIAL */
 
-    /* Multi-cron context version of lwdtc_cron_is_valid_for_time */
-    while (ctx_len-- > 0) {
-        res = lwdtc_cron_is_valid_for_time(tm_time, cron_ctx++);
-        if (res != lwdtcOK) {
-            break;
+    ctx = cron_ctx[0];
+    for (size_t i = 1; i < ctx_len; ++i) {
+        for (size_t f = 0; f < PRV_FIELD_NUM; ++f) {
+            uint8_t* map = PRV_FIELD_MAP_RW(&ctx, f);
+            const uint8_t* map_in = PRV_FIELD_MAP(&cron_ctx[i], f);
+
+            for (size_t b = 0; b < PRV_FIELD_SIZE(f); ++b) {
+                map[b] &= map_in[b];
+            }
         }
     }
-    return res;
+    prv_prepare_flags(&ctx);
+    *out_ctx = ctx;
+    return lwdtcOK;
+}
+
+/**
+ * \brief           Check if first context is subsumed by the second context
+ * 
+ * Every time when first context is valid, the second context is valid too,
+ * making first context redundant in the OR operation.
+ * Context that can never be valid is a subset of any context
+ * 
+ * \param[in]       ctx_a: Cron context to check
+ * \param[in]       ctx_b: Cron context that potentially subsumes `ctx_a`
+ * \return          \ref lwdtcOK if `ctx_a` is a subset of `ctx_b`, member of \ref lwdtcr_t otherwise 
+ */
+lwdtcr_t
+lwdtc_cron_is_subset(const lwdtc_cron_ctx_t* ctx_a, const lwdtc_cron_ctx_t* ctx_b) {
+    ASSERT_PARAM(ctx_a != NULL && ctx_b != NULL);
+
+    return prv_is_subset(ctx_a, ctx_b) ? lwdtcOK : lwdtcERR;
+}
+
+/**
+ * \brief           Merge two contexts into one, valid exactly when at least one of them is valid (OR operation)
+ * 
+ * Union can be represented with single context only when
+ * contexts are different in at most one field, or when one subsumes the other.
+ * 
+ * \param[out]      out_ctx: Output cron context. It may point to one of the input contexts.
+ *                      It is not modified if contexts cannot be merged
+ * \param[in]       ctx_a: First cron context
+ * \param[in]       ctx_b: Second cron context
+ * \return          \ref lwdtcOK if merged, \ref lwdtcERR if union cannot be represented
+ *                      with one context, member of \ref lwdtcr_t otherwise 
+ */
+lwdtcr_t
+lwdtc_cron_merge(lwdtc_cron_ctx_t* out_ctx, const lwdtc_cron_ctx_t* ctx_a, const lwdtc_cron_ctx_t* ctx_b) {
+    lwdtc_cron_ctx_t ctx;
+    uint32_t diff;
+
+    ASSERT_PARAM(out_ctx != NULL && ctx_a != NULL && ctx_b != NULL);
+
+    if (prv_is_subset(ctx_a, ctx_b)) {
+        ctx = *ctx_b;
+    } else if (prv_is_subset(ctx_b, ctx_a)) {
+        ctx = *ctx_a;
+    } else {
+        /* Only one field may be different, to keep union exact */
+        diff = prv_get_diff_fields(ctx_a, ctx_b);
+        if (diff & (diff - 1)) {
+            return lwdtcERR;
+        }
+        ctx = *ctx_a;
+        for (size_t f = 0; f < PRV_FIELD_NUM; ++f) {
+            if (diff & (1UL << f)) {
+                uint8_t* map = PRV_FIELD_MAP_RW(&ctx, f);
+                const uint8_t* map_b = PRV_FIELD_MAP(ctx_b, f);
+
+                for (size_t b = 0; b < PRV_FIELD_SIZE(f); ++b) {
+                    map[b] |= map_b[b];
+                }
+            }
+        }
+    }
+    prv_prepare_flags(&ctx);
+    *out_ctx = ctx;
+    return lwdtcOK;
+}
+
+/**
+ * \brief           Build set of contexts, valid when first context is valid and second is not ("A except B")
+ * 
+ * Difference is split into up to \ref LWDTC_CRON_EXCEPT_MAX disjoint contexts,
+ * one for each field where the second context does not cover the first one.
+ * Use \ref lwdtc_cron_is_valid_for_time_multi_or to check the result
+ * 
+ * \note            Contexts with special day operators, `L`, `W` or `#`, are not supported
+ *                      and function returns \ref lwdtcERR
+ * 
+ * \param[out]      out_ctx: Pointer to output array of cron contexts.
+ *                      Array must not overlap with input contexts
+ * \param[in]       out_ctx_len: Length of output array. Set to \ref LWDTC_CRON_EXCEPT_MAX to always fit the result
+ * \param[out]      out_cnt: Pointer to output variable to store number of written contexts.
+ *                      It is set to `0` when first context is fully covered by the second one
+ * \param[in]       ctx_a: Cron context to include
+ * \param[in]       ctx_b: Cron context to exclude
+ * \return          \ref lwdtcOK on success, member of \ref lwdtcr_t otherwise 
+ */
+lwdtcr_t
+lwdtc_cron_except(lwdtc_cron_ctx_t* out_ctx, size_t out_ctx_len, size_t* out_cnt, const lwdtc_cron_ctx_t* ctx_a,
+                  const lwdtc_cron_ctx_t* ctx_b) {
+    lwdtc_cron_ctx_t ctx_and;
+    size_t cnt = 0;
+
+    ASSERT_PARAM(out_ctx != NULL && out_cnt != NULL && ctx_a != NULL && ctx_b != NULL);
+#if LWDTC_CFG_DAY_SPECIAL
+    ASSERT_ACTION(!prv_has_day_special(ctx_a) && !prv_has_day_special(ctx_b));
+#endif /* LWDTC_CFG_DAY_SPECIAL */
+
+    /* Nothing to exclude when there is no common time */
+    ctx_and = *ctx_a;
+    for (size_t f = 0; f < PRV_FIELD_NUM; ++f) {
+        uint8_t* map = PRV_FIELD_MAP_RW(&ctx_and, f);
+        const uint8_t* map_b = PRV_FIELD_MAP(ctx_b, f);
+
+        for (size_t b = 0; b < PRV_FIELD_SIZE(f); ++b) {
+            map[b] &= map_b[b];
+        }
+    }
+    if (prv_is_empty(&ctx_and)) {
+        ASSERT_ACTION(out_ctx_len > 0);
+        out_ctx[0] = *ctx_a;
+        *out_cnt = prv_is_empty(ctx_a) ? 0 : 1;
+        return lwdtcOK;
+    }
+
+    /*
+     * Time is in A and not in B, when at least one field of the time is not part of B.
+     *
+     * For each field "f" build disjoint context:
+     * - Fields before "f" are from A AND B (these are not the reason for exclusion)
+     * - Field "f" is from A AND NOT B (the reason for exclusion)
+     * - Fields after "f" are from A
+     */
+    for (size_t f = 0; f < PRV_FIELD_NUM; ++f) {
+        lwdtc_cron_ctx_t ctx = *ctx_a;
+        uint8_t* map = PRV_FIELD_MAP_RW(&ctx, f);
+        const uint8_t* map_b = PRV_FIELD_MAP(ctx_b, f);
+
+        for (size_t pf = 0; pf < f; ++pf) {
+            memcpy(PRV_FIELD_MAP_RW(&ctx, pf), PRV_FIELD_MAP(&ctx_and, pf), PRV_FIELD_SIZE(pf));
+        }
+        for (size_t b = 0; b < PRV_FIELD_SIZE(f); ++b) {
+            map[b] &= ~map_b[b];
+        }
+        if (!prv_is_empty(&ctx)) {
+            ASSERT_ACTION(cnt < out_ctx_len);
+            prv_prepare_flags(&ctx);
+            out_ctx[cnt++] = ctx;
+        }
+    }
+    *out_cnt = cnt;
+    return lwdtcOK;
+}
+
+/**
+ * \brief           Reduce array of contexts to the fewest contexts,
+ *                      valid exactly at the same times (OR operation)
+ * 
+ * It removes contexts that can never be valid, contexts subsumed by other contexts,
+ * and merges contexts that are different in one field only.
+ * Relative order of remaining contexts is kept.
+ * 
+ * \param[in,out]   cron_ctx: Pointer to array of cron ctx objects, modified in place
+ * \param[in]       ctx_len: Number of context array length
+ * \param[out]      new_len: Pointer to output variable to store new number of contexts in the array
+ * \return          \ref lwdtcOK on success, member of \ref lwdtcr_t otherwise 
+ */
+lwdtcr_t
+lwdtc_cron_optimize(lwdtc_cron_ctx_t* cron_ctx, size_t ctx_len, size_t* new_len) {
+    uint8_t changed;
+
+    ASSERT_PARAM(cron_ctx != NULL && new_len != NULL);
+
+#define REMOVE_CTX(idx)                                                                                                \
+    do {                                                                                                               \
+        memmove(&cron_ctx[(idx)], &cron_ctx[(idx) + 1], (ctx_len - (idx)-1) * sizeof(*cron_ctx));                     \
+        --ctx_len;                                                                                                     \
+    } while (0)
+
+    /* Remove contexts that are never valid */
+    for (size_t i = 0; i < ctx_len;) {
+        if (prv_is_empty(&cron_ctx[i])) {
+            REMOVE_CTX(i);
+        } else {
+            ++i;
+        }
+    }
+
+    /* Merging may enable further merges, repeat until nothing changes */
+    do {
+        changed = 0;
+        for (size_t i = 0; i < ctx_len; ++i) {
+            for (size_t j = i + 1; j < ctx_len;) {
+                if (lwdtc_cron_merge(&cron_ctx[i], &cron_ctx[i], &cron_ctx[j]) == lwdtcOK) {
+                    REMOVE_CTX(j);
+                    changed = 1;
+                } else {
+                    ++j;
+                }
+            }
+        }
+    } while (changed);
+#undef REMOVE_CTX
+
+    *new_len = ctx_len;
+    return lwdtcOK;
 }
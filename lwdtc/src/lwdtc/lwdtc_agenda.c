@@ -0,0 +1,161 @@
+/**
+ * \file            lwdtc_agenda.c
+ * \brief           LwDTC agenda of multiple cron contexts
+ */
+
+/*
+ * Copyright (c) 2024 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwDTC - Lightweight Date, Time & Cron library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v1.0.0
+ */
+#include "lwdtc/lwdtc_agenda.h"
+
+/* Internal defines */
+#define ASSERT_WITH_RETURN(c, retval)                                                                                  \
+    if (!(c)) {                                                                                                        \
+        return retval;                                                                                                 \
+    }
+#define ASSERT_PARAM(c)  ASSERT_WITH_RETURN(c, lwdtcERRPAR)
+#define ASSERT_ACTION(c) ASSERT_WITH_RETURN(c, lwdtcERR)
+
+/**
+ * \brief           Check if first event comes before the second one
+ * \param[in]       a: First event
+ * \param[in]       b: Second event
+ * \return          `1` if `a` is before `b`, `0` otherwise
+ */
+static uint8_t
+prv_is_before(const lwdtc_agenda_event_t* a, const lwdtc_agenda_event_t* b) {
+    return a->time < b->time || (a->time == b->time && a->ctx_index < b->ctx_index);
+}
+
+/**
+ * \brief           Move heap event down, until heap order is restored
+ * \param[in,out]   agenda: Agenda handle
+ * \param[in]       pos: Position of the event in the heap
+ */
+static void
+prv_sift_down(lwdtc_agenda_t* agenda, size_t pos) {
+    lwdtc_agenda_event_t ev = agenda->heap[pos];
+
+    for (size_t child; (child = 2 * pos + 1) < agenda->heap_len; pos = child) {
+        if (child + 1 < agenda->heap_len && prv_is_before(&agenda->heap[child + 1], &agenda->heap[child])) {
+            ++child;
+        }
+        if (!prv_is_before(&agenda->heap[child], &ev)) {
+            break;
+        }
+        agenda->heap[pos] = agenda->heap[child];
+    }
+    agenda->heap[pos] = ev;
+}
+
+/**
+ * \brief           Initialize agenda for the time window
+ * 
+ * Next fire time of every context is calculated, and contexts with no fire time
+ * in the window are not part of the heap.
+ * 
+ * \param[out]      agenda: Agenda handle
+ * \param[in]       heap: Pointer to memory for the heap, with `ctx_len` events
+ * \param[in]       cron_ctx: Pointer to array of cron contexts.
+ *                      Array must stay valid and unchanged, while the agenda is used
+ * \param[in]       ctx_len: Number of contexts in the array
+ * \param[in]       start: Start of the window, included
+ * \param[in]       end: End of the window, not included
+ * \param[in]       cursor: Last event of the previous page, to resume the agenda after it.
+ *                      Set to `NULL` to start at the beginning of the window
+ * \return          \ref lwdtcOK on success, member of \ref lwdtcr_t otherwise
+ */
+lwdtcr_t
+lwdtc_agenda_init(lwdtc_agenda_t* agenda, lwdtc_agenda_event_t* heap, const lwdtc_cron_ctx_t* cron_ctx,
+                  size_t ctx_len, time_t start, time_t end, const lwdtc_agenda_event_t* cursor) {
+    ASSERT_PARAM(agenda != NULL && (heap != NULL || ctx_len == 0) && (cron_ctx != NULL || ctx_len == 0));
+
+    agenda->ctx = cron_ctx;
+    agenda->end = end;
+    agenda->heap = heap;
+    agenda->heap_len = 0;
+    for (size_t i = 0; i < ctx_len; ++i) {
+        time_t curr = start - 1;
+
+        /* Events of the context up to the cursor have been returned already */
+        if (cursor != NULL) {
+            time_t after = cursor->time - (i > cursor->ctx_index ? 1 : 0);
+
+            if (after > curr) {
+                curr = after;
+            }
+        }
+        if (lwdtc_cron_next(&cron_ctx[i], curr, &heap[agenda->heap_len].time) == lwdtcOK
+            && heap[agenda->heap_len].time < end) {
+            heap[agenda->heap_len++].ctx_index = i;
+        }
+    }
+
+    /* Build the heap bottom-up */
+    for (size_t i = agenda->heap_len / 2; i > 0; --i) {
+        prv_sift_down(agenda, i - 1);
+    }
+    return lwdtcOK;
+}
+
+/**
+ * \brief           Get next page of agenda events
+ * 
+ * Agenda is finished, when number of returned events is lower than buffer length.
+ * Last returned event can be used as cursor in \ref lwdtc_agenda_init,
+ * to get next page with new agenda object
+ * 
+ * \param[in,out]   agenda: Agenda handle
+ * \param[out]      events: Pointer to output buffer for events
+ * \param[in]       events_len: Length of the buffer
+ * \param[out]      events_cnt: Pointer to output variable to store number of returned events
+ * \return          \ref lwdtcOK on success, member of \ref lwdtcr_t otherwise
+ */
+lwdtcr_t
+lwdtc_agenda_get(lwdtc_agenda_t* agenda, lwdtc_agenda_event_t* events, size_t events_len, size_t* events_cnt) {
+    size_t cnt = 0;
+
+    ASSERT_PARAM(agenda != NULL && (events != NULL || events_len == 0) && events_cnt != NULL);
+
+    for (; cnt < events_len && agenda->heap_len > 0; ++cnt) {
+        lwdtc_agenda_event_t* top = &agenda->heap[0];
+
+        events[cnt] = *top;
+
+        /* Replace top with next event of the same context, or remove it when context is done */
+        if (lwdtc_cron_next(&agenda->ctx[top->ctx_index], top->time, &top->time) != lwdtcOK
+            || top->time >= agenda->end) {
+            *top = agenda->heap[--agenda->heap_len];
+        }
+        if (agenda->heap_len > 0) {
+            prv_sift_down(agenda, 0);
+        }
+    }
+    *events_cnt = cnt;
+    return lwdtcOK;
+}
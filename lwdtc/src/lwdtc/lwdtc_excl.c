@@ -0,0 +1,304 @@
+/**
+ * \file            lwdtc_excl.c
+ * \brief           LwDTC exclusion calendar
+ */
+
+/*
+ * Copyright (c) 2024 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwDTC - Lightweight Date, Time & Cron library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v1.0.0
+ */
+#include <stdint.h>
+#include <string.h>
+#include "lwdtc/lwdtc_excl.h"
+#include "lwdtc/lwdtc_private.h"
+
+/* Internal defines */
+#define ASSERT_WITH_RETURN(c, retval)                                                                                  \
+    if (!(c)) {                                                                                                        \
+        return retval;                                                                                                 \
+    }
+#define ASSERT_PARAM(c)  ASSERT_WITH_RETURN(c, lwdtcERRPAR)
+#define ASSERT_ACTION(c) ASSERT_WITH_RETURN(c, lwdtcERR)
+
+#define CHAR_IS_NUM(c)   ((c) >= '0' && (c) <= '9')
+#define CHAR_TO_NUM(c)   ((c) - '0')
+#define CHAR_IS_SPACE(c) ((c) == ' ' || (c) == '\t' || (c) == '\r')
+
+/**
+ * \brief           Get day in a year, starting with `0` for January 1st
+ * \param[in]       year: Full year number
+ * \param[in]       mon: Month, `1` to `12`
+ * \param[in]       mday: Day in a month, `1` to `31`
+ * \return          Day in a year, `-1` if date is not valid
+ */
+static int32_t
+prv_get_yday(int32_t year, uint32_t mon, uint32_t mday) {
+    uint32_t yday = mday - 1;
+
+    if (mon < LWDTC_MON_MIN || mon > LWDTC_MON_MAX || mday < 1 || mday > lwdtci_get_month_days(year, mon)) {
+        return -1;
+    }
+    for (uint32_t m = LWDTC_MON_MIN; m < mon; ++m) {
+        yday += lwdtci_get_month_days(year, m);
+    }
+    return (int32_t)yday;
+}
+
+/**
+ * \brief           Initialize empty exclusion calendar
+ * \param[out]      excl: Exclusion calendar to initialize
+ * \param[in]       years: Array of year entries, used as memory for the calendar
+ * \param[in]       years_len: Length of the array, maximum number of years with excluded days
+ * \return          \ref lwdtcOK on success, member of \ref lwdtcr_t otherwise
+ */
+lwdtcr_t
+lwdtc_excl_init(lwdtc_excl_t* excl, lwdtc_excl_year_t* years, size_t years_len) {
+    ASSERT_PARAM(excl != NULL && years != NULL && years_len > 0);
+
+    LWDTC_MEMSET(excl, 0x00, sizeof(*excl));
+    excl->years = years;
+    excl->years_len = years_len;
+    return lwdtcOK;
+}
+
+/**
+ * \brief           Add excluded day to the calendar
+ * \param[in,out]   excl: Exclusion calendar
+ * \param[in]       year: Full year number
+ * \param[in]       mon: Month, `1` to `12`
+ * \param[in]       mday: Day in a month, `1` to `31`
+ * \return          \ref lwdtcOK on success, \ref lwdtcERR if there is no free year entry for new year,
+ *                      member of \ref lwdtcr_t otherwise
+ */
+lwdtcr_t
+lwdtc_excl_add(lwdtc_excl_t* excl, int32_t year, uint32_t mon, uint32_t mday) {
+    int32_t yday = prv_get_yday(year, mon, mday);
+    size_t pos;
+
+    ASSERT_PARAM(excl != NULL && excl->years != NULL && yday >= 0);
+
+    /* Find the year, or insert new one, to keep the list sorted */
+    for (pos = 0; pos < excl->years_num && excl->years[pos].year < year; ++pos) {}
+    if (pos == excl->years_num || excl->years[pos].year != year) {
+        ASSERT_ACTION(excl->years_num < excl->years_len);
+        for (size_t i = excl->years_num; i > pos; --i) {
+            excl->years[i] = excl->years[i - 1];
+        }
+        LWDTC_MEMSET(&excl->years[pos], 0x00, sizeof(excl->years[pos]));
+        excl->years[pos].year = year;
+        ++excl->years_num;
+    }
+    excl->years[pos].days[(uint32_t)yday >> 5U] |= 1UL << ((uint32_t)yday & 0x1FU);
+    return lwdtcOK;
+}
+
+/**
+ * \brief           Check if day is excluded by the calendar
+ * \param[in]       excl: Exclusion calendar
+ * \param[in]       year: Full year number
+ * \param[in]       mon: Month, `1` to `12`
+ * \param[in]       mday: Day in a month, `1` to `31`
+ * \return          \ref lwdtcOK if day is excluded, \ref lwdtcERR if it is not,
+ *                      member of \ref lwdtcr_t otherwise
+ */
+lwdtcr_t
+lwdtc_excl_is_excluded(const lwdtc_excl_t* excl, int32_t year, uint32_t mon, uint32_t mday) {
+    int32_t yday = prv_get_yday(year, mon, mday);
+
+    ASSERT_PARAM(excl != NULL && yday >= 0);
+
+    for (size_t i = 0; i < excl->years_num && excl->years[i].year <= year; ++i) {
+        if (excl->years[i].year == year) {
+            return (excl->years[i].days[(uint32_t)yday >> 5U] & (1UL << ((uint32_t)yday & 0x1FU))) ? lwdtcOK
+                                                                                                 : lwdtcERR;
+        }
+    }
+    return lwdtcERR;
+}
+
+/**
+ * \brief           Parse date in `YYYY-MM-DD` format
+ * \param[in]       str: Input string
+ * \param[in]       len: Length of input string
+ * \param[in,out]   index: Index in the string, moved after the date
+ * \param[out]      year: Full year number
+ * \param[out]      mon: Month
+ * \param[out]      mday: Day in a month
+ * \return          \ref lwdtcOK on success, \ref lwdtcERRTOKEN otherwise
+ */
+static lwdtcr_t
+prv_parse_date(const char* str, size_t len, size_t* index, int32_t* year, uint32_t* mon, uint32_t* mday) {
+    static const uint8_t digits[] = {4, 2, 2};
+    uint32_t val[3];
+    size_t i = *index;
+
+    for (size_t p = 0; p < LWDTC_ARRAYSIZE(digits); ++p) {
+        if (p > 0) {
+            ASSERT_WITH_RETURN(i < len && str[i] == '-', lwdtcERRTOKEN);
+            ++i;
+        }
+        val[p] = 0;
+        for (size_t d = 0; d < digits[p]; ++d, ++i) {
+            ASSERT_WITH_RETURN(i < len && CHAR_IS_NUM(str[i]), lwdtcERRTOKEN);
+            val[p] = val[p] * 10 + (uint32_t)CHAR_TO_NUM(str[i]);
+        }
+    }
+    ASSERT_WITH_RETURN(prv_get_yday((int32_t)val[0], val[1], val[2]) >= 0, lwdtcERRTOKEN);
+    *year = (int32_t)val[0];
+    *mon = val[1];
+    *mday = val[2];
+    *index = i;
+    return lwdtcOK;
+}
+
+/**
+ * \brief           Check if calendar has entry for the year
+ * \param[in]       excl: Exclusion calendar
+ * \param[in]       year: Full year number
+ * \return          `1` if year is in the calendar, `0` otherwise
+ */
+static uint8_t
+prv_has_year(const lwdtc_excl_t* excl, int32_t year) {
+    for (size_t i = 0; i < excl->years_num && excl->years[i].year <= year; ++i) {
+        if (excl->years[i].year == year) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * \brief           Parse calendar text and add its days to the calendar
+ * \param[in,out]   excl: Exclusion calendar
+ * \param[in]       str: Calendar text
+ * \param[in]       str_len: Length of the text
+ * \param[in]       skip: Calendar with years, which days are not added. Set to `NULL` to add all days
+ * \param[out]      line: Output line number, that failed to parse
+ * \return          \ref lwdtcOK on success, member of \ref lwdtcr_t otherwise
+ */
+static lwdtcr_t
+prv_parse_text(lwdtc_excl_t* excl, const char* str, size_t str_len, const lwdtc_excl_t* skip, size_t* line) {
+    lwdtcr_t res = lwdtcOK;
+    size_t i = 0;
+
+    *line = 0;
+    while (res == lwdtcOK && i < str_len) {
+        int32_t year, year_end;
+        uint32_t mon, mday, mon_end, mday_end;
+
+        ++*line;
+        for (; i < str_len && CHAR_IS_SPACE(str[i]); ++i) {}
+        if (i < str_len && str[i] != '\n' && str[i] != '#') {
+            /* Single date or range of dates */
+            if ((res = prv_parse_date(str, str_len, &i, &year, &mon, &mday)) != lwdtcOK) {
+                break;
+            }
+            year_end = year, mon_end = mon, mday_end = mday;
+            if (i + 1 < str_len && str[i] == '.' && str[i + 1] == '.') {
+                i += 2;
+                if ((res = prv_parse_date(str, str_len, &i, &year_end, &mon_end, &mday_end)) != lwdtcOK) {
+                    break;
+                }
+                if (year_end < year || (year_end == year && (mon_end < mon || (mon_end == mon && mday_end < mday)))) {
+                    res = lwdtcERRTOKEN;
+                    break;
+                }
+            }
+
+            /* Only spaces and comment may follow */
+            for (; i < str_len && CHAR_IS_SPACE(str[i]); ++i) {}
+            if (i < str_len && str[i] != '\n' && str[i] != '#') {
+                res = lwdtcERRTOKEN;
+                break;
+            }
+
+            /* Add all days of the range, except days of skipped years */
+            while (((skip != NULL && prv_has_year(skip, year))
+                    || (res = lwdtc_excl_add(excl, year, mon, mday)) == lwdtcOK)
+                   && (year != year_end || mon != mon_end || mday != mday_end)) {
+                if (++mday > lwdtci_get_month_days(year, mon)) {
+                    mday = 1;
+                    if (++mon > LWDTC_MON_MAX) {
+                        mon = LWDTC_MON_MIN;
+                        ++year;
+                    }
+                }
+            }
+        }
+
+        /* Skip the rest of the line */
+        for (; i < str_len && str[i] != '\n'; ++i) {}
+        ++i;
+    }
+    return res;
+}
+
+/**
+ * \brief           Parse exclusion calendar from text and add its days to the calendar
+ * 
+ * Text has one entry per line, either single date `YYYY-MM-DD`, or range of dates `YYYY-MM-DD..YYYY-MM-DD`,
+ * with both edges included. Empty lines are ignored, `#` starts a comment until the end of line.
+ * 
+ * \code{.txt}
+ * # Public holidays
+ * 2024-01-01
+ * 2024-12-24..2024-12-26 # Christmas
+ * \endcode
+ * 
+ * Calendar is modified only when the whole text is valid and all its years fit to the calendar.
+ * Text is first parsed to free year entries of the calendar, used as scratch memory,
+ * and added to the calendar only after that.
+ * 
+ * \param[in,out]   excl: Exclusion calendar, initialized with \ref lwdtc_excl_init
+ * \param[in]       str: Calendar text, typically content of the file
+ * \param[in]       str_len: Length of the text
+ * \param[out]      fail_line: Optional pointer to output line number, starting with `1`, that failed to parse.
+ *                      Set to `NULL` if not used
+ * \return          \ref lwdtcOK on success, \ref lwdtcERRTOKEN if line is not valid,
+ *                      \ref lwdtcERR if there is no free year entry, member of \ref lwdtcr_t otherwise
+ */
+lwdtcr_t
+lwdtc_excl_parse(lwdtc_excl_t* excl, const char* str, size_t str_len, size_t* fail_line) {
+    lwdtc_excl_t scratch;
+    lwdtcr_t res;
+    size_t line;
+
+    ASSERT_PARAM(excl != NULL && excl->years != NULL && str != NULL);
+
+    /* Scratch calendar gets only the years, that are new to the calendar */
+    scratch.years = &excl->years[excl->years_num];
+    scratch.years_len = excl->years_len - excl->years_num;
+    scratch.years_num = 0;
+    if ((res = prv_parse_text(&scratch, str, str_len, excl, &line)) == lwdtcOK) {
+        /* Text is valid and fits to the calendar, parsing it again cannot fail */
+        res = prv_parse_text(excl, str, str_len, NULL, &line);
+    }
+    if (res != lwdtcOK && fail_line != NULL) {
+        *fail_line = line;
+    }
+    return res;
+}
@@ -0,0 +1,245 @@
+/**
+ * \file            lwdtc_journal.c
+ * \brief           LwDTC persistent scheduler state journal
+ */
+
+/*
+ * Copyright (c) 2024 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwDTC - Lightweight Date, Time & Cron library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v1.0.0
+ */
+#include <stdint.h>
+#include <string.h>
+#include "lwdtc/lwdtc_journal.h"
+
+/* Internal defines */
+#define ASSERT_WITH_RETURN(c, retval)                                                                                  \
+    if (!(c)) {                                                                                                        \
+        return retval;                                                                                                 \
+    }
+#define ASSERT_PARAM(c)  ASSERT_WITH_RETURN(c, lwdtcERRPAR)
+#define ASSERT_ACTION(c) ASSERT_WITH_RETURN(c, lwdtcERR)
+
+/**
+ * \brief           Calculate CRC-32 (IEEE 802.3, reflected) of the data
+ * \param[in]       data: Data to calculate CRC for
+ * \param[in]       len: Length of data in units of bytes
+ * \return          CRC-32 value
+ */
+static uint32_t
+prv_crc32(const void* data, size_t len) {
+    const uint8_t* d = data;
+    uint32_t crc = 0xFFFFFFFFUL;
+
+    while (len-- > 0) {
+        crc ^= *d++;
+        for (size_t i = 0; i < 8; ++i) {
+            crc = (crc >> 1U) ^ (0xEDB88320UL & (0UL - (crc & 0x01U)));
+        }
+    }
+    return ~crc;
+}
+
+/**
+ * \brief           Check if record has valid checksum
+ * \param[in]       rec: Record to check
+ * \return          `1` if valid, `0` otherwise
+ */
+static uint8_t
+prv_record_is_valid(const lwdtc_journal_record_t* rec) {
+    return rec->crc == prv_crc32(rec, offsetof(lwdtc_journal_record_t, crc));
+}
+
+/**
+ * \brief           Get the newest valid record of the entry
+ * \param[in]       entry: Journal entry
+ * \return          Pointer to newest valid record, `NULL` if none is valid
+ */
+static const lwdtc_journal_record_t*
+prv_get_newest(const lwdtc_journal_entry_t* entry) {
+    uint8_t valid0 = prv_record_is_valid(&entry->slot[0]), valid1 = prv_record_is_valid(&entry->slot[1]);
+
+    /* Sequence number wraps around, newer record is ahead in serial number arithmetic */
+    if (valid0 && valid1) {
+        return (int32_t)(entry->slot[1].seq - entry->slot[0].seq) > 0 ? &entry->slot[1] : &entry->slot[0];
+    }
+    return valid0 ? &entry->slot[0] : (valid1 ? &entry->slot[1] : NULL);
+}
+
+/**
+ * \brief           Format new journal in the memory region. All entries are set as empty
+ * \param[out]      journal: Journal handle to initialize
+ * \param[in]       mem: Memory region for the journal
+ * \param[in]       mem_size: Size of memory region in units of bytes.
+ *                      Use \ref LWDTC_JOURNAL_MEM_SIZE to calculate required size
+ * \param[in]       entries_num: Number of job entries
+ * \return          \ref lwdtcOK on success, member of \ref lwdtcr_t otherwise
+ */
+lwdtcr_t
+lwdtc_journal_format(lwdtc_journal_t* journal, void* mem, size_t mem_size, size_t entries_num) {
+    lwdtc_journal_hdr_t* hdr = mem;
+
+    ASSERT_PARAM(journal != NULL && mem != NULL && entries_num > 0 && entries_num <= UINT32_MAX);
+    ASSERT_PARAM(mem_size >= LWDTC_JOURNAL_MEM_SIZE(entries_num));
+
+    LWDTC_MEMSET(mem, 0x00, LWDTC_JOURNAL_MEM_SIZE(entries_num));
+    hdr->magic = LWDTC_JOURNAL_MAGIC;
+    hdr->version = LWDTC_JOURNAL_VERSION;
+    hdr->record_size = (uint16_t)sizeof(lwdtc_journal_record_t);
+    hdr->entries_num = (uint32_t)entries_num;
+    hdr->crc = prv_crc32(hdr, offsetof(lwdtc_journal_hdr_t, crc));
+
+    journal->hdr = hdr;
+    journal->entries = (lwdtc_journal_entry_t*)(hdr + 1);
+    journal->entries_num = entries_num;
+    return lwdtcOK;
+}
+
+/**
+ * \brief           Attach to existing journal in the memory region, after restart.
+ * 
+ * Only the header is validated, records are validated on read
+ * \param[out]      journal: Journal handle to initialize
+ * \param[in]       mem: Memory region with the journal
+ * \param[in]       mem_size: Size of memory region in units of bytes
+ * \return          \ref lwdtcOK on success, \ref lwdtcERR if memory doesn't hold valid journal,
+ *                      member of \ref lwdtcr_t otherwise
+ */
+lwdtcr_t
+lwdtc_journal_attach(lwdtc_journal_t* journal, void* mem, size_t mem_size) {
+    lwdtc_journal_hdr_t* hdr = mem;
+
+    ASSERT_PARAM(journal != NULL && mem != NULL);
+    ASSERT_ACTION(mem_size >= sizeof(*hdr));
+    ASSERT_ACTION(hdr->magic == LWDTC_JOURNAL_MAGIC && hdr->version == LWDTC_JOURNAL_VERSION
+                  && hdr->record_size == sizeof(lwdtc_journal_record_t)
+                  && hdr->crc == prv_crc32(hdr, offsetof(lwdtc_journal_hdr_t, crc)));
+    ASSERT_ACTION(hdr->entries_num > 0 && mem_size >= LWDTC_JOURNAL_MEM_SIZE(hdr->entries_num));
+
+    journal->hdr = hdr;
+    journal->entries = (lwdtc_journal_entry_t*)(hdr + 1);
+    journal->entries_num = hdr->entries_num;
+    return lwdtcOK;
+}
+
+/**
+ * \brief           Write new state of the job to the journal
+ * 
+ * Older record slot of the entry is overwritten, newest valid state stays untouched
+ * 
+ * \param[in]       journal: Journal handle
+ * \param[in]       index: Job entry index
+ * \param[in]       id: Job identifier, defined by application
+ * \param[in]       last_fired: Last time job fired
+ * \param[in]       next_due: Next time job is due to fire
+ * \return          \ref lwdtcOK on success, member of \ref lwdtcr_t otherwise
+ */
+lwdtcr_t
+lwdtc_journal_write(lwdtc_journal_t* journal, size_t index, uint32_t id, time_t last_fired, time_t next_due) {
+    const lwdtc_journal_record_t* newest;
+    lwdtc_journal_record_t rec, *slot;
+
+    ASSERT_PARAM(journal != NULL && journal->entries != NULL && index < journal->entries_num);
+
+    /* Write to the slot that does not hold the newest record */
+    newest = prv_get_newest(&journal->entries[index]);
+    slot = &journal->entries[index].slot[newest == &journal->entries[index].slot[0] ? 1 : 0];
+
+    LWDTC_MEMSET(&rec, 0x00, sizeof(rec));
+    rec.id = id;
+    rec.seq = newest != NULL ? newest->seq + 1 : 1;
+    rec.last_fired = (int64_t)last_fired;
+    rec.next_due = (int64_t)next_due;
+    rec.crc = prv_crc32(&rec, offsetof(lwdtc_journal_record_t, crc));
+    *slot = rec;
+    return lwdtcOK;
+}
+
+/**
+ * \brief           Read the newest valid state of the job from the journal
+ * \param[in]       journal: Journal handle
+ * \param[in]       index: Job entry index
+ * \param[out]      id: Optional pointer to output job identifier. Set to `NULL` if not used
+ * \param[out]      last_fired: Optional pointer to output last fire time. Set to `NULL` if not used
+ * \param[out]      next_due: Optional pointer to output next due time. Set to `NULL` if not used
+ * \return          \ref lwdtcOK on success, \ref lwdtcERR if entry has no valid record,
+ *                      member of \ref lwdtcr_t otherwise
+ */
+lwdtcr_t
+lwdtc_journal_read(const lwdtc_journal_t* journal, size_t index, uint32_t* id, time_t* last_fired, time_t* next_due) {
+    const lwdtc_journal_record_t* rec;
+
+    ASSERT_PARAM(journal != NULL && journal->entries != NULL && index < journal->entries_num);
+
+    rec = prv_get_newest(&journal->entries[index]);
+    ASSERT_ACTION(rec != NULL);
+    if (id != NULL) {
+        *id = rec->id;
+    }
+    if (last_fired != NULL) {
+        *last_fired = (time_t)rec->last_fired;
+    }
+    if (next_due != NULL) {
+        *next_due = (time_t)rec->next_due;
+    }
+    return lwdtcOK;
+}
+
+/**
+ * \brief           Get list of fire times missed by the job, from its stored next due time up to current time
+ * 
+ * Search starts at stored next due time, no recalculation is done for jobs that are not overdue
+ * 
+ * \param[in]       journal: Journal handle
+ * \param[in]       index: Job entry index
+ * \param[in]       cron_ctx: Cron context of the job
+ * \param[in]       curr_time: Current time
+ * \param[out]      missed: Pointer to output array of missed fire times, in ascending order
+ * \param[in]       missed_len: Length of output array
+ * \param[out]      missed_cnt: Pointer to output variable to store number of missed fire times.
+ *                      When equal to `missed_len`, there may be more missed times after the last one written.
+ *                      Application can get them by calling \ref lwdtc_cron_next from the last written time
+ * \return          \ref lwdtcOK on success, \ref lwdtcERR if entry has no valid record,
+ *                      member of \ref lwdtcr_t otherwise
+ */
+lwdtcr_t
+lwdtc_journal_get_missed(const lwdtc_journal_t* journal, size_t index, const lwdtc_cron_ctx_t* cron_ctx,
+                         time_t curr_time, time_t* missed, size_t missed_len, size_t* missed_cnt) {
+    time_t next_due;
+    size_t cnt = 0;
+
+    ASSERT_PARAM(cron_ctx != NULL && missed != NULL && missed_cnt != NULL);
+    ASSERT_ACTION(lwdtc_journal_read(journal, index, NULL, NULL, &next_due) == lwdtcOK);
+
+    while (cnt < missed_len && next_due <= curr_time) {
+        missed[cnt++] = next_due;
+        if (lwdtc_cron_next(cron_ctx, next_due, &next_due) != lwdtcOK) {
+            break;
+        }
+    }
+    *missed_cnt = cnt;
+    return lwdtcOK;
+}
@@ -0,0 +1,273 @@
+/**
+ * \file            lwdtc_reload.c
+ * \brief           LwDTC incremental reload of cron tables
+ */
+
+/*
+ * Copyright (c) 2024 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwDTC - Lightweight Date, Time & Cron library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v1.0.0
+ */
+#include <stdint.h>
+#include <string.h>
+#include "lwdtc/lwdtc_reload.h"
+
+/* Internal defines */
+#define ASSERT_WITH_RETURN(c, retval)                                                                                  \
+    if (!(c)) {                                                                                                        \
+        return retval;                                                                                                 \
+    }
+#define ASSERT_PARAM(c)  ASSERT_WITH_RETURN(c, lwdtcERRPAR)
+#define ASSERT_ACTION(c) ASSERT_WITH_RETURN(c, lwdtcERR)
+
+#define CHAR_IS_SPACE(c) ((c) == ' ' || (c) == '\t' || (c) == '\r')
+
+/*
+ * Hash index memory layout, for maximum "n" entries:
+ *
+ * - 2n bucket heads, with index + 1 of first previous version entry in the bucket, 0 when empty
+ * - n links to next previous version entry in the same bucket
+ * - n states of previous version entries, with index + 1 of matched new version entry, 0 when removed
+ *
+ * While new version is built, ID of its entry keeps index + 1 of matched previous version entry,
+ * with PRV_PAIRED flag for changed entry, or 0 for added entry
+ */
+#define PRV_PAIRED 0x80000000UL
+
+/* Check if entries have the same line */
+#define PRV_IS_SAME(a, b) ((a)->hash == (b)->hash && (a)->str_len == (b)->str_len)
+
+/**
+ * \brief           Calculate FNV-1a hash of the line
+ * \param[in]       str: Line
+ * \param[in]       len: Line length
+ * \return          Hash value
+ */
+static uint64_t
+prv_hash(const char* str, size_t len) {
+    uint64_t hash = 0xCBF29CE484222325ULL;
+
+    for (size_t i = 0; i < len; ++i) {
+        hash ^= (uint8_t)str[i];
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+/**
+ * \brief           Initialize reloadable table with no entries
+ * \param[out]      reload: Table handle
+ * \param[in]       entries: Pointer to memory for entries, with `2 * entries_max` entries
+ * \param[in]       entries_max: Maximum number of entries in the table
+ * \param[in]       scratch: Pointer to hash index memory,
+ *                      with \ref LWDTC_RELOAD_SCRATCH_LEN `(entries_max)` words
+ * \return          \ref lwdtcOK on success, member of \ref lwdtcr_t otherwise
+ */
+lwdtcr_t
+lwdtc_reload_init(lwdtc_reload_t* reload, lwdtc_reload_entry_t* entries, size_t entries_max, uint32_t* scratch) {
+    ASSERT_PARAM(reload != NULL && entries != NULL && entries_max > 0 && entries_max < PRV_PAIRED
+                 && scratch != NULL);
+
+    LWDTC_MEMSET(reload, 0x00, sizeof(*reload));
+    reload->entries[0] = entries;
+    reload->entries[1] = entries + entries_max;
+    reload->entries_max = entries_max;
+    reload->scratch = scratch;
+    reload->next_id = 1;
+    return lwdtcOK;
+}
+
+/**
+ * \brief           Load new version of the table text
+ * 
+ * Lines are compared with the previous version by their hashes, and only new lines are parsed.
+ * Callback is then called for every removed, changed and added entry.
+ * First load reports all entries as added.
+ * 
+ * When text is not valid, table keeps previous version and no callback is called.
+ * 
+ * \param[in,out]   reload: Table handle
+ * \param[in]       str: Table text, typically content of the file.
+ *                      Entries point to it, text must be kept until next successful load
+ * \param[in]       str_len: Length of the text
+ * \param[in]       evt_fn: Callback for entry changes. Set to `NULL` if not used
+ * \param[in]       arg: User argument for the callback
+ * \param[out]      fail_line: Optional pointer to output line number, starting with `1`, that failed to parse.
+ *                      Set to `NULL` if not used
+ * \return          \ref lwdtcOK on success, \ref lwdtcERRTOKEN if line is not valid,
+ *                      \ref lwdtcERR if there are too many entries, member of \ref lwdtcr_t otherwise
+ */
+lwdtcr_t
+lwdtc_reload_load(lwdtc_reload_t* reload, const char* str, size_t str_len, lwdtc_reload_evt_fn evt_fn, void* arg,
+                  size_t* fail_line) {
+    const lwdtc_reload_entry_t* old;
+    lwdtc_reload_entry_t* entries;
+    uint32_t *bucket, *link, *state;
+    size_t buckets_len, old_len, len = 0, line = 0, prev;
+
+    ASSERT_PARAM(reload != NULL && (str != NULL || str_len == 0));
+
+    old = reload->entries[reload->curr];
+    old_len = reload->entries_len;
+    entries = reload->entries[reload->curr ^ 1U];
+    buckets_len = 2 * reload->entries_max;
+    bucket = reload->scratch;
+    link = bucket + buckets_len;
+    state = link + reload->entries_max;
+
+    /* Split text to lines and hash them */
+    for (size_t i = 0, start, end; i < str_len; i = end + 1) {
+        ++line;
+        for (; i < str_len && CHAR_IS_SPACE(str[i]); ++i) {}
+        for (start = i, end = i; end < str_len && str[end] != '\n'; ++end) {}
+        for (i = end; i > start && CHAR_IS_SPACE(str[i - 1]); --i) {}
+        if (i == start || str[start] == '#') {
+            continue;
+        }
+        if (len == reload->entries_max) {
+            if (fail_line != NULL) {
+                *fail_line = line;
+            }
+            return lwdtcERR;
+        }
+        entries[len].hash = prv_hash(&str[start], i - start);
+        entries[len].id = 0;
+        entries[len].line = (uint32_t)line;
+        entries[len].str = &str[start];
+        entries[len].str_len = i - start;
+        ++len;
+    }
+
+    /*
+     * Match unchanged lines at the same position first, that is the most of them.
+     * Single removed line is skipped, to keep the following lines at the same position
+     */
+    LWDTC_MEMSET(state, 0x00, old_len * sizeof(*state));
+    for (size_t j = 0, k = 0; j < len && k < old_len; ++j) {
+        if (!PRV_IS_SAME(&old[k], &entries[j]) && k + 1 < old_len && PRV_IS_SAME(&old[k + 1], &entries[j])) {
+            ++k;
+        }
+        if (PRV_IS_SAME(&old[k], &entries[j])) {
+            state[k] = (uint32_t)(j + 1);
+            entries[j].id = (uint32_t)(k + 1);
+            entries[j].ctx = old[k].ctx;
+            ++k;
+        }
+    }
+
+    /* Index remaining entries of previous version by hash, entries of each bucket are kept in the original order */
+    LWDTC_MEMSET(bucket, 0x00, buckets_len * sizeof(*bucket));
+    for (size_t k = old_len; k > 0; --k) {
+        if (state[k - 1] == 0) {
+            size_t b = (size_t)(old[k - 1].hash % buckets_len);
+
+            link[k - 1] = bucket[b];
+            bucket[b] = (uint32_t)k;
+        }
+    }
+
+    /* Match remaining lines, each previous version entry is used only once */
+    for (size_t j = 0; j < len; ++j) {
+        if (entries[j].id == 0) {
+            for (uint32_t* p = &bucket[(size_t)(entries[j].hash % buckets_len)]; *p != 0; p = &link[*p - 1]) {
+                if (PRV_IS_SAME(&old[*p - 1], &entries[j])) {
+                    state[*p - 1] = (uint32_t)(j + 1);
+                    entries[j].id = *p;
+                    entries[j].ctx = old[*p - 1].ctx;
+                    *p = link[*p - 1]; /* Remove from the bucket */
+                    break;
+                }
+            }
+        }
+    }
+
+    /*
+     * Parse new lines. New line that follows the same entry as unmatched line of previous version,
+     * replaces that line, and is reported as changed entry
+     */
+    prev = 0;
+    for (size_t j = 0; j < len; ++j) {
+        if (entries[j].id == 0) {
+            if (prev < old_len && state[prev] == 0) {
+                state[prev] = (uint32_t)(j + 1);
+                entries[j].id = (uint32_t)(prev + 1) | PRV_PAIRED;
+            }
+            if (lwdtc_cron_parse_with_len(&entries[j].ctx, entries[j].str, entries[j].str_len) != lwdtcOK) {
+                if (fail_line != NULL) {
+                    *fail_line = entries[j].line;
+                }
+                return lwdtcERRTOKEN;
+            }
+        }
+        if (entries[j].id != 0) {
+            prev = (entries[j].id & ~PRV_PAIRED);
+        }
+    }
+
+    /* New version is valid, switch to it and assign IDs */
+    reload->curr ^= 1U;
+    reload->entries_len = len;
+    for (size_t k = 0; k < old_len; ++k) {
+        if (state[k] == 0 && evt_fn != NULL) {
+            evt_fn(LWDTC_RELOAD_REMOVED, &old[k], arg);
+        }
+    }
+    for (size_t j = 0; j < len; ++j) {
+        lwdtc_reload_evt_t evt = LWDTC_RELOAD_CHANGED;
+
+        if (entries[j].id == 0) {
+            evt = LWDTC_RELOAD_ADDED;
+            entries[j].id = reload->next_id++;
+            if (reload->next_id == 0) {
+                reload->next_id = 1;
+            }
+        } else if (entries[j].id & PRV_PAIRED) {
+            entries[j].id = old[(entries[j].id & ~PRV_PAIRED) - 1].id;
+        } else {
+            entries[j].id = old[entries[j].id - 1].id;
+            continue;
+        }
+        if (evt_fn != NULL) {
+            evt_fn(evt, &entries[j], arg);
+        }
+    }
+    return lwdtcOK;
+}
+
+/**
+ * \brief           Get entries of current version
+ * \param[in]       reload: Table handle
+ * \param[out]      entries_len: Pointer to output variable to store number of entries
+ * \return          Pointer to array of entries
+ */
+const lwdtc_reload_entry_t*
+lwdtc_reload_get_entries(const lwdtc_reload_t* reload, size_t* entries_len) {
+    if (reload == NULL || entries_len == NULL) {
+        return NULL;
+    }
+    *entries_len = reload->entries_len;
+    return reload->entries[reload->curr];
+}
@@ -0,0 +1,259 @@
+/**
+ * \file            lwdtc_rtc.c
+ * \brief           LwDTC RTC alarm programming
+ */
+
+/*
+ * Copyright (c) 2024 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwDTC - Lightweight Date, Time & Cron library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v1.0.0
+ */
+#include <stdint.h>
+#include <string.h>
+#include "lwdtc/lwdtc_rtc.h"
+
+/* Internal defines */
+#define ASSERT_WITH_RETURN(c, retval)                                                                                  \
+    if (!(c)) {                                                                                                        \
+        return retval;                                                                                                 \
+    }
+#define ASSERT_PARAM(c)  ASSERT_WITH_RETURN(c, lwdtcERRPAR)
+#define ASSERT_ACTION(c) ASSERT_WITH_RETURN(c, lwdtcERR)
+
+#define BIT_IS_SET(map, pos) ((map)[(pos) >> 3U] & (1U << ((pos) & 0x07U)))
+
+/* Field kinds, as seen by the alarm comparator */
+#define PRV_FIELD_ANY    0 /*!< All values are set, field is don't care */
+#define PRV_FIELD_SINGLE 1 /*!< Single value is set, field is compared */
+#define PRV_FIELD_OTHER  2 /*!< Field cannot be expressed with the alarm */
+
+/**
+ * \brief           Get field kind from its bit-map
+ * \param[in]       map: Field bit-map
+ * \param[in]       size: Size of field bit-map in bytes
+ * \param[in]       min: Minimum field value
+ * \param[in]       max: Maximum field value
+ * \param[out]      val: Value of the field, when single value is set
+ * \return          Field kind, `PRV_FIELD_x`
+ */
+static uint8_t
+prv_field_kind(const uint8_t* map, size_t size, uint32_t min, uint32_t max, uint8_t* val) {
+    uint32_t cnt = 0;
+
+    for (uint32_t i = min; i <= max; ++i) {
+        if (BIT_IS_SET(map, i)) {
+            *val = (uint8_t)i;
+            ++cnt;
+        }
+    }
+
+    /* Bits above the field range are special day operators, such as last day in month */
+    for (size_t i = (max >> 3U) + 1U; i < size && cnt < max - min + 1; ++i) {
+        if (map[i]) {
+            return PRV_FIELD_OTHER;
+        }
+    }
+    return cnt == max - min + 1 ? PRV_FIELD_ANY : (cnt == 1 ? PRV_FIELD_SINGLE : PRV_FIELD_OTHER);
+}
+
+/* Get kind of the context field */
+#define PRV_FIELD_KIND(ctx, field, min, max, val) prv_field_kind((ctx)->field, sizeof((ctx)->field), (min), (max), (val))
+
+/**
+ * \brief           Set alarm field from field kind
+ * \param[in,out]   alarm: Alarm to update
+ * \param[in]       field: Alarm field, `LWDTC_RTC_ALARM_x`
+ * \param[in]       kind: Field kind
+ * \param[in]       hw_fields: Fields supported by the hardware
+ * \return          `1` if field is expressed exactly, `0` otherwise
+ */
+static uint8_t
+prv_field_set(lwdtc_rtc_alarm_t* alarm, uint8_t field, uint8_t kind, uint8_t hw_fields) {
+    if (kind == PRV_FIELD_ANY) {
+        alarm->dont_care |= field;
+        return 1;
+    }
+    return kind == PRV_FIELD_SINGLE && (hw_fields & field);
+}
+
+/**
+ * \brief           Try to express single cron context with the alarm exactly
+ * \param[in]       cron_ctx: Cron context
+ * \param[in]       hw_fields: Fields supported by the hardware, `LWDTC_RTC_ALARM_x`
+ * \param[out]      alarm: Alarm to fill
+ * \return          `1` if alarm fires exactly at all fire times of the context, `0` otherwise
+ */
+static uint8_t
+prv_alarm_repeat(const lwdtc_cron_ctx_t* cron_ctx, uint8_t hw_fields, lwdtc_rtc_alarm_t* alarm) {
+    uint8_t kind_mday, kind_wday, tmp;
+
+    alarm->dont_care = 0;
+#if LWDTC_CFG_FIELD_SEC
+    if (!prv_field_set(alarm, LWDTC_RTC_ALARM_SEC,
+                       PRV_FIELD_KIND(cron_ctx, sec, LWDTC_SEC_MIN, LWDTC_SEC_MAX, &alarm->sec), hw_fields)) {
+        return 0;
+    }
+#else  /* LWDTC_CFG_FIELD_SEC */
+    alarm->sec = 0;
+    if (!(hw_fields & LWDTC_RTC_ALARM_SEC)) {
+        return 0;
+    }
+#endif /* !LWDTC_CFG_FIELD_SEC */
+    if (!prv_field_set(alarm, LWDTC_RTC_ALARM_MIN,
+                       PRV_FIELD_KIND(cron_ctx, min, LWDTC_MIN_MIN, LWDTC_MIN_MAX, &alarm->min), hw_fields)
+        || !prv_field_set(alarm, LWDTC_RTC_ALARM_HOUR,
+                          PRV_FIELD_KIND(cron_ctx, hour, LWDTC_HOUR_MIN, LWDTC_HOUR_MAX, &alarm->hour), hw_fields)) {
+        return 0;
+    }
+
+    /* Month and year are never compared by the alarm */
+    if (PRV_FIELD_KIND(cron_ctx, mon, LWDTC_MON_MIN, LWDTC_MON_MAX, &tmp) != PRV_FIELD_ANY) {
+        return 0;
+    }
+#if LWDTC_CFG_FIELD_YEAR
+    if (PRV_FIELD_KIND(cron_ctx, year, LWDTC_YEAR_MIN, LWDTC_YEAR_MAX, &tmp) != PRV_FIELD_ANY) {
+        return 0;
+    }
+#endif /* LWDTC_CFG_FIELD_YEAR */
+
+    /* Both day fields may only be compared together, when hardware allows it */
+    kind_mday = PRV_FIELD_KIND(cron_ctx, mday, LWDTC_MDAY_MIN, LWDTC_MDAY_MAX, &alarm->mday);
+    kind_wday = PRV_FIELD_KIND(cron_ctx, wday, LWDTC_WDAY_MIN, LWDTC_WDAY_MAX, &alarm->wday);
+    if ((hw_fields & LWDTC_RTC_ALARM_DAY_EITHER) && kind_mday != PRV_FIELD_ANY && kind_wday != PRV_FIELD_ANY) {
+        return 0;
+    }
+    return prv_field_set(alarm, LWDTC_RTC_ALARM_MDAY, kind_mday, hw_fields)
+           && prv_field_set(alarm, LWDTC_RTC_ALARM_WDAY, kind_wday, hw_fields);
+}
+
+/**
+ * \brief           Get RTC alarm for earliest next fire time among multiple cron contexts
+ * 
+ * When single context consists of fields with either all values or single value,
+ * and hardware supports the fields with single value, alarm matches exactly all fire times of the cron.
+ * It is set as repeating alarm, such as `0 30 6 * * 1 *` for every Monday at `06:30:00`.
+ * 
+ * Otherwise all fields supported by the hardware are set to the next fire time.
+ * When such alarm fires before the next fire time, for example when next fire time is in another month,
+ * or hardware does not compare all the fields, alarm is intermediate wake-up.
+ * Application then calls the function again on wake-up, to program next alarm.
+ * 
+ * \param[in]       cron_ctx: Pointer to array of cron ctx objects
+ * \param[in]       ctx_len: Number of context array length
+ * \param[in]       curr_time: Current time, used as reference to get new time
+ * \param[in]       hw_fields: Bit-mask of `LWDTC_RTC_ALARM_x` fields, that can be compared by the hardware
+ * \param[out]      alarm: Pointer to output alarm settings
+ * \return          \ref lwdtcOK on success, \ref lwdtcERR if no cron fires in supported year range,
+ *                      member of \ref lwdtcr_t otherwise
+ */
+lwdtcr_t
+lwdtc_rtc_alarm_next(const lwdtc_cron_ctx_t* cron_ctx, size_t ctx_len, time_t curr_time, uint8_t hw_fields,
+                     lwdtc_rtc_alarm_t* alarm) {
+    lwdtc_cron_ctx_t alarm_ctx;
+    struct tm tm_time;
+    time_t next;
+    size_t idx;
+
+    ASSERT_PARAM(cron_ctx != NULL && ctx_len > 0 && alarm != NULL);
+    ASSERT_PARAM(hw_fields & (LWDTC_RTC_ALARM_SEC | LWDTC_RTC_ALARM_MIN | LWDTC_RTC_ALARM_HOUR | LWDTC_RTC_ALARM_MDAY
+                              | LWDTC_RTC_ALARM_WDAY));
+    ASSERT_ACTION(lwdtc_cron_next_multi(cron_ctx, ctx_len, curr_time, &next, &idx) == lwdtcOK);
+
+    LWDTC_MEMSET(alarm, 0x00, sizeof(*alarm));
+    alarm->ctx_index = idx;
+    alarm->time = next;
+    alarm->is_fire = 1;
+    if (ctx_len == 1 && prv_alarm_repeat(cron_ctx, hw_fields, alarm)) {
+        alarm->is_repeat = 1;
+        return lwdtcOK;
+    }
+
+    /* Compare all supported fields with the next fire time */
+    LWDTC_CFG_GET_LOCALTIME(&tm_time, &next);
+    alarm->sec = (uint8_t)tm_time.tm_sec;
+    alarm->min = (uint8_t)tm_time.tm_min;
+    alarm->hour = (uint8_t)tm_time.tm_hour;
+    alarm->mday = (uint8_t)tm_time.tm_mday;
+    alarm->wday = (uint8_t)tm_time.tm_wday;
+    alarm->dont_care = (uint8_t)(~hw_fields & (LWDTC_RTC_ALARM_SEC | LWDTC_RTC_ALARM_MIN | LWDTC_RTC_ALARM_HOUR
+                                               | LWDTC_RTC_ALARM_MDAY | LWDTC_RTC_ALARM_WDAY));
+    if ((hw_fields & LWDTC_RTC_ALARM_DAY_EITHER) && !(alarm->dont_care & LWDTC_RTC_ALARM_MDAY)) {
+        alarm->dont_care |= LWDTC_RTC_ALARM_WDAY;
+    }
+
+    /*
+     * Alarm itself is described with cron context,
+     * to find out when it fires for the first time.
+     *
+     * Fire time of the cron always matches the alarm, alarm cannot fire later than that
+     */
+    LWDTC_MEMSET(&alarm_ctx, 0xFF, sizeof(alarm_ctx));
+    alarm_ctx.flags = 0;
+#if LWDTC_CFG_FIELD_SEC
+    if (!(alarm->dont_care & LWDTC_RTC_ALARM_SEC)) {
+        LWDTC_MEMSET(alarm_ctx.sec, 0x00, sizeof(alarm_ctx.sec));
+        alarm_ctx.sec[alarm->sec >> 3U] = (uint8_t)(1U << (alarm->sec & 0x07U));
+    }
+#endif /* LWDTC_CFG_FIELD_SEC */
+    if (!(alarm->dont_care & LWDTC_RTC_ALARM_MIN)) {
+        LWDTC_MEMSET(alarm_ctx.min, 0x00, sizeof(alarm_ctx.min));
+        alarm_ctx.min[alarm->min >> 3U] = (uint8_t)(1U << (alarm->min & 0x07U));
+    }
+    if (!(alarm->dont_care & LWDTC_RTC_ALARM_HOUR)) {
+        LWDTC_MEMSET(alarm_ctx.hour, 0x00, sizeof(alarm_ctx.hour));
+        alarm_ctx.hour[alarm->hour >> 3U] = (uint8_t)(1U << (alarm->hour & 0x07U));
+    }
+    if (!(alarm->dont_care & LWDTC_RTC_ALARM_MDAY)) {
+        LWDTC_MEMSET(alarm_ctx.mday, 0x00, sizeof(alarm_ctx.mday));
+        alarm_ctx.mday[alarm->mday >> 3U] = (uint8_t)(1U << (alarm->mday & 0x07U));
+    }
+    if (!(alarm->dont_care & LWDTC_RTC_ALARM_WDAY)) {
+        LWDTC_MEMSET(alarm_ctx.wday, 0x00, sizeof(alarm_ctx.wday));
+        alarm_ctx.wday[0] = (uint8_t)(1U << alarm->wday);
+    }
+    if (lwdtc_cron_next(&alarm_ctx, curr_time, &alarm->time) != lwdtcOK || alarm->time > next) {
+        alarm->time = next;
+    }
+    alarm->is_fire = alarm->time == next;
+    return lwdtcOK;
+}
+
+/**
+ * \brief           Check if alarm matches the time, as hardware alarm comparator does.
+ *                  It can be used to implement alarm with software RTC
+ * \param[in]       alarm: Alarm settings
+ * \param[in]       tm_time: Current time of the RTC
+ * \return          `1` if alarm matches, `0` otherwise
+ */
+uint8_t
+lwdtc_rtc_alarm_is_match(const lwdtc_rtc_alarm_t* alarm, const struct tm* tm_time) {
+    return alarm != NULL && tm_time != NULL
+           && ((alarm->dont_care & LWDTC_RTC_ALARM_SEC) || tm_time->tm_sec == alarm->sec)
+           && ((alarm->dont_care & LWDTC_RTC_ALARM_MIN) || tm_time->tm_min == alarm->min)
+           && ((alarm->dont_care & LWDTC_RTC_ALARM_HOUR) || tm_time->tm_hour == alarm->hour)
+           && ((alarm->dont_care & LWDTC_RTC_ALARM_MDAY) || tm_time->tm_mday == alarm->mday)
+           && ((alarm->dont_care & LWDTC_RTC_ALARM_WDAY) || tm_time->tm_wday == alarm->wday);
+}
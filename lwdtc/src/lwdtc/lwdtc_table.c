@@ -0,0 +1,307 @@
+/**
+ * \file            lwdtc_table.c
+ * \brief           LwDTC compact cron table with interned fields
+ */
+
+/*
+ * Copyright (c) 2024 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwDTC - Lightweight Date, Time & Cron library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v1.0.0
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "lwdtc/lwdtc_table.h"
+#include "lwdtc/lwdtc_private.h"
+
+/* Internal defines */
+#define ASSERT_WITH_RETURN(c, retval)                                                                                  \
+    if (!(c)) {                                                                                                        \
+        return retval;                                                                                                 \
+    }
+#define ASSERT_PARAM(c)  ASSERT_WITH_RETURN(c, lwdtcERRPAR)
+#define ASSERT_ACTION(c) ASSERT_WITH_RETURN(c, lwdtcERR)
+
+#define BIT_IS_SET(map, pos) ((map)[(pos) >> 3U] & (1U << ((pos) & 0x07U)))
+
+/* Get bit-map of the field in the pool */
+#define PRV_POOL_MAP(table, f, idx) (&(table)->pool[(f)].maps[(size_t)(idx) * prv_fields[(f)].size])
+
+/**
+ * \brief           Field descriptor
+ */
+typedef struct {
+    uint8_t offset; /*!< Offset of the field in the context */
+    uint8_t size;   /*!< Size of the field bit-map in bytes */
+    uint8_t max;    /*!< Maximum value of the field */
+} prv_field_t;
+
+/* Fields, in the order of the context */
+static const prv_field_t prv_fields[LWDTC_TABLE_FIELDS_NUM] = {
+#if LWDTC_CFG_FIELD_SEC
+    {offsetof(lwdtc_cron_ctx_t, sec), sizeof(((lwdtc_cron_ctx_t*)0)->sec), LWDTC_SEC_MAX},
+#endif /* LWDTC_CFG_FIELD_SEC */
+    {offsetof(lwdtc_cron_ctx_t, min), sizeof(((lwdtc_cron_ctx_t*)0)->min), LWDTC_MIN_MAX},
+    {offsetof(lwdtc_cron_ctx_t, hour), sizeof(((lwdtc_cron_ctx_t*)0)->hour), LWDTC_HOUR_MAX},
+    {offsetof(lwdtc_cron_ctx_t, mday), sizeof(((lwdtc_cron_ctx_t*)0)->mday), LWDTC_MDAY_MAX},
+    {offsetof(lwdtc_cron_ctx_t, mon), sizeof(((lwdtc_cron_ctx_t*)0)->mon), LWDTC_MON_MAX},
+    {offsetof(lwdtc_cron_ctx_t, wday), sizeof(((lwdtc_cron_ctx_t*)0)->wday), LWDTC_WDAY_MAX},
+#if LWDTC_CFG_FIELD_YEAR
+    {offsetof(lwdtc_cron_ctx_t, year), sizeof(((lwdtc_cron_ctx_t*)0)->year), LWDTC_YEAR_MAX},
+#endif /* LWDTC_CFG_FIELD_YEAR */
+};
+
+/**
+ * \brief           Get values of all fields from the time, in the order of fields
+ * \param[in]       tm_time: Time
+ * \param[out]      val: Field values. Value above field maximum never matches
+ */
+static void
+prv_get_values(const struct tm* tm_time, uint32_t* val) {
+    size_t f = 0;
+
+#if LWDTC_CFG_FIELD_SEC
+    val[f++] = (uint32_t)tm_time->tm_sec;
+#endif /* LWDTC_CFG_FIELD_SEC */
+    val[f++] = (uint32_t)tm_time->tm_min;
+    val[f++] = (uint32_t)tm_time->tm_hour;
+    val[f++] = (uint32_t)tm_time->tm_mday;
+    val[f++] = (uint32_t)(tm_time->tm_mon + 1);
+    val[f++] = (uint32_t)tm_time->tm_wday;
+#if LWDTC_CFG_FIELD_YEAR
+    val[f++] = (uint32_t)(tm_time->tm_year - 100);
+#endif /* LWDTC_CFG_FIELD_YEAR */
+}
+
+/**
+ * \brief           Check if time value matches the field bit-map
+ * \param[in]       f: Field index
+ * \param[in]       map: Field bit-map
+ * \param[in]       val: Time value of the field
+ * \param[in]       tm_time: Time
+ * \return          `1` if value matches, `0` otherwise
+ */
+static uint8_t
+prv_is_match(size_t f, const uint8_t* map, uint32_t val, const struct tm* tm_time) {
+    if (val <= prv_fields[f].max && BIT_IS_SET(map, val)) {
+        return 1;
+    }
+#if LWDTC_CFG_DAY_SPECIAL
+    /* Special day operators, stored above field values, depend on the whole date */
+    if (prv_fields[f].offset == offsetof(lwdtc_cron_ctx_t, mday)) {
+        return lwdtci_mday_is_set(map, (uint32_t)(tm_time->tm_year - 100), (uint32_t)(tm_time->tm_mon + 1), val,
+                                  (uint32_t)tm_time->tm_wday);
+    } else if (prv_fields[f].offset == offsetof(lwdtc_cron_ctx_t, wday)) {
+        return lwdtci_wday_is_set(map, (uint32_t)(tm_time->tm_year - 100), (uint32_t)(tm_time->tm_mon + 1),
+                                  (uint32_t)tm_time->tm_mday, val);
+    }
+#else
+    (void)tm_time;
+#endif /* LWDTC_CFG_DAY_SPECIAL */
+    return 0;
+}
+
+/**
+ * \brief           Find bit-map in the field pool
+ * \param[in]       table: Table handle
+ * \param[in]       f: Field index
+ * \param[in]       map: Bit-map to find
+ * \param[out]      slot: Hash slot of the bit-map, or first empty slot when not found
+ * \return          Bit-map index, `SIZE_MAX` if not found
+ */
+static size_t
+prv_pool_find(const lwdtc_table_t* table, size_t f, const uint8_t* map, size_t* slot) {
+    const lwdtc_table_pool_t* pool = &table->pool[f];
+    size_t slots_len = 2 * table->maps_len, pos;
+    uint32_t hash = 0x811C9DC5UL;
+
+    /* FNV-1a hash with linear probing, pool is never more than half full */
+    for (size_t i = 0; i < prv_fields[f].size; ++i) {
+        hash = (hash ^ map[i]) * 0x01000193UL;
+    }
+    for (pos = hash % slots_len; pool->slots[pos] != 0; pos = (pos + 1) % slots_len) {
+        if (memcmp(PRV_POOL_MAP(table, f, pool->slots[pos] - 1U), map, prv_fields[f].size) == 0) {
+            *slot = pos;
+            return pool->slots[pos] - 1U;
+        }
+    }
+    *slot = pos;
+    return SIZE_MAX;
+}
+
+/**
+ * \brief           Initialize empty table in the memory region
+ * \param[out]      table: Table handle to initialize
+ * \param[in]       mem: Memory region for the bit-maps, aligned to at least `2` bytes
+ * \param[in]       mem_size: Size of memory region in units of bytes.
+ *                      Use \ref LWDTC_TABLE_MEM_SIZE to calculate required size
+ * \param[in]       maps_len: Maximum number of distinct bit-maps per field,
+ *                      up to \ref LWDTC_TABLE_MAPS_MAX
+ * \return          \ref lwdtcOK on success, member of \ref lwdtcr_t otherwise
+ */
+lwdtcr_t
+lwdtc_table_init(lwdtc_table_t* table, void* mem, size_t mem_size, size_t maps_len) {
+    uint8_t* ptr = mem;
+
+    ASSERT_PARAM(table != NULL && mem != NULL && maps_len > 0 && maps_len <= LWDTC_TABLE_MAPS_MAX);
+    ASSERT_PARAM(mem_size >= LWDTC_TABLE_MEM_SIZE(maps_len));
+
+    /* Hash slots first, to keep their alignment */
+    LWDTC_MEMSET(table, 0x00, sizeof(*table));
+    LWDTC_MEMSET(mem, 0x00, LWDTC_TABLE_MEM_SIZE(maps_len));
+    for (size_t f = 0; f < LWDTC_TABLE_FIELDS_NUM; ++f) {
+        table->pool[f].slots = (uint16_t*)(void*)ptr;
+        ptr += 2 * maps_len * sizeof(uint16_t);
+    }
+    for (size_t f = 0; f < LWDTC_TABLE_FIELDS_NUM; ++f) {
+        table->pool[f].maps = ptr;
+        ptr += maps_len * prv_fields[f].size;
+        table->pool[f].hit = ptr;
+        ptr += maps_len;
+    }
+    table->maps_len = maps_len;
+    return lwdtcOK;
+}
+
+/**
+ * \brief           Add context to the table.
+ *                  Bit-maps of its fields are added to the pools, unless they are already there
+ * \param[in,out]   table: Table handle
+ * \param[in]       cron_ctx: Cron context to add
+ * \param[out]      entry: Table entry for the context, kept by the application
+ * \return          \ref lwdtcOK on success, \ref lwdtcERR if any field pool is full,
+ *                      member of \ref lwdtcr_t otherwise
+ */
+lwdtcr_t
+lwdtc_table_add(lwdtc_table_t* table, const lwdtc_cron_ctx_t* cron_ctx, lwdtc_table_entry_t* entry) {
+    size_t idx[LWDTC_TABLE_FIELDS_NUM], slot[LWDTC_TABLE_FIELDS_NUM];
+
+    ASSERT_PARAM(table != NULL && table->maps_len > 0 && cron_ctx != NULL && entry != NULL);
+
+    /* Check all the fields first, table is not modified on failure */
+    for (size_t f = 0; f < LWDTC_TABLE_FIELDS_NUM; ++f) {
+        idx[f] = prv_pool_find(table, f, (const uint8_t*)cron_ctx + prv_fields[f].offset, &slot[f]);
+        ASSERT_ACTION(idx[f] != SIZE_MAX || table->pool[f].num < table->maps_len);
+    }
+    for (size_t f = 0; f < LWDTC_TABLE_FIELDS_NUM; ++f) {
+        lwdtc_table_pool_t* pool = &table->pool[f];
+
+        if (idx[f] == SIZE_MAX) {
+            idx[f] = pool->num++;
+            memcpy(PRV_POOL_MAP(table, f, idx[f]), (const uint8_t*)cron_ctx + prv_fields[f].offset,
+                   prv_fields[f].size);
+            pool->slots[slot[f]] = (uint16_t)(idx[f] + 1U);
+        }
+        entry->field[f] = (uint16_t)idx[f];
+    }
+    return lwdtcOK;
+}
+
+/**
+ * \brief           Get full cron context of the table entry, for use with other library functions,
+ *                  such as \ref lwdtc_cron_next
+ * \param[in]       table: Table handle
+ * \param[in]       entry: Table entry
+ * \param[out]      cron_ctx: Pointer to output cron context
+ * \return          \ref lwdtcOK on success, member of \ref lwdtcr_t otherwise
+ */
+lwdtcr_t
+lwdtc_table_get_ctx(const lwdtc_table_t* table, const lwdtc_table_entry_t* entry, lwdtc_cron_ctx_t* cron_ctx) {
+    ASSERT_PARAM(table != NULL && entry != NULL && cron_ctx != NULL);
+
+    LWDTC_MEMSET(cron_ctx, 0x00, sizeof(*cron_ctx));
+    for (size_t f = 0; f < LWDTC_TABLE_FIELDS_NUM; ++f) {
+        ASSERT_PARAM(entry->field[f] < table->pool[f].num);
+        memcpy((uint8_t*)cron_ctx + prv_fields[f].offset, PRV_POOL_MAP(table, f, entry->field[f]),
+               prv_fields[f].size);
+    }
+    return lwdtc_cron_prepare(cron_ctx);
+}
+
+/**
+ * \brief           Check if table entry is valid at specific time
+ * \param[in]       table: Table handle
+ * \param[in]       entry: Table entry
+ * \param[in]       tm_time: Time to check
+ * \return          \ref lwdtcOK if valid, \ref lwdtcERR if not, member of \ref lwdtcr_t otherwise
+ */
+lwdtcr_t
+lwdtc_table_is_valid_for_time(const lwdtc_table_t* table, const lwdtc_table_entry_t* entry,
+                              const struct tm* tm_time) {
+    uint32_t val[LWDTC_TABLE_FIELDS_NUM];
+
+    ASSERT_PARAM(table != NULL && entry != NULL && tm_time != NULL);
+
+    prv_get_values(tm_time, val);
+    for (size_t f = 0; f < LWDTC_TABLE_FIELDS_NUM; ++f) {
+        ASSERT_PARAM(entry->field[f] < table->pool[f].num);
+        if (!prv_is_match(f, PRV_POOL_MAP(table, f, entry->field[f]), val[f], tm_time)) {
+            return lwdtcERR;
+        }
+    }
+    return lwdtcOK;
+}
+
+/**
+ * \brief           Check which table entries are valid at specific time
+ * 
+ * Every distinct bit-map is checked only once. Entries are then resolved
+ * with one lookup per field, to the match result of its bit-map
+ * 
+ * \param[in,out]   table: Table handle. Match results of the bit-maps are kept in the table
+ * \param[in]       entries: Pointer to array of table entries
+ * \param[in]       entries_len: Number of table entries
+ * \param[in]       tm_time: Time to check
+ * \param[out]      out_bits: Pointer to output bit-map, with `(entries_len + 7) / 8` bytes.
+ *                      Bit `i` is set, when entry `i` is valid at the time
+ * \return          \ref lwdtcOK on success, member of \ref lwdtcr_t otherwise
+ */
+lwdtcr_t
+lwdtc_table_match(lwdtc_table_t* table, const lwdtc_table_entry_t* entries, size_t entries_len,
+                  const struct tm* tm_time, uint8_t* out_bits) {
+    uint32_t val[LWDTC_TABLE_FIELDS_NUM];
+
+    ASSERT_PARAM(table != NULL && entries != NULL && tm_time != NULL && out_bits != NULL);
+
+    prv_get_values(tm_time, val);
+    for (size_t f = 0; f < LWDTC_TABLE_FIELDS_NUM; ++f) {
+        for (size_t i = 0; i < table->pool[f].num; ++i) {
+            table->pool[f].hit[i] = prv_is_match(f, PRV_POOL_MAP(table, f, i), val[f], tm_time);
+        }
+    }
+
+    LWDTC_MEMSET(out_bits, 0x00, (entries_len + 7) / 8);
+    for (size_t i = 0; i < entries_len; ++i) {
+        uint8_t hit = 1;
+
+        for (size_t f = 0; hit && f < LWDTC_TABLE_FIELDS_NUM; ++f) {
+            ASSERT_PARAM(entries[i].field[f] < table->pool[f].num);
+            hit = table->pool[f].hit[entries[i].field[f]];
+        }
+        out_bits[i >> 3U] |= (uint8_t)(hit << (i & 0x07U));
+    }
+    return lwdtcOK;
+}
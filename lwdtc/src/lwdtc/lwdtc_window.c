@@ -0,0 +1,280 @@
+/**
+ * \file            lwdtc_window.c
+ * \brief           LwDTC cron time windows
+ */
+
+/*
+ * Copyright (c) 2024 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwDTC - Lightweight Date, Time & Cron library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v1.0.0
+ */
+#include <string.h>
+#include "lwdtc/lwdtc_window.h"
+
+/* Internal defines */
+#define ASSERT_WITH_RETURN(c, retval)                                                                                  \
+    if (!(c)) {                                                                                                        \
+        return retval;                                                                                                 \
+    }
+#define ASSERT_PARAM(c)  ASSERT_WITH_RETURN(c, lwdtcERRPAR)
+#define ASSERT_ACTION(c) ASSERT_WITH_RETURN(c, lwdtcERR)
+
+/* Window state flags */
+#define PRV_FLAG_VALID    0x01 /*!< State is known for interval between `from` and `edge` */
+#define PRV_FLAG_OPEN     0x02 /*!< Window is open */
+#define PRV_FLAG_HAS_EDGE 0x04 /*!< There is next transition. When not set, state does not change anymore */
+
+#define PRV_EXTEND_MAX    32 /*!< Maximum number of fire times checked for the edge in single evaluation */
+#define PRV_SEARCH_SPANS  5  /*!< Number of backward search spans, each is `64` times longer than previous one */
+
+/**
+ * \brief           Get last fire time of the context, before or at current time
+ * 
+ * Search goes backwards in growing spans, until span with at least one fire time is found.
+ * Fire times more than `2^30` seconds (about 34 years) before current time are not considered
+ * 
+ * \param[in]       ctx: Cron context
+ * \param[in,out]   cache: Day cache for the context
+ * \param[in]       curr_time: Current time
+ * \param[out]      last_time: Pointer to output last fire time
+ * \return          `1` if found, `0` otherwise
+ */
+static uint8_t
+prv_get_last(const lwdtc_cron_ctx_t* ctx, lwdtc_cron_daycache_t* cache, time_t curr_time, time_t* last_time) {
+    time_t time, next;
+    size_t i;
+
+    for (i = 1; i <= PRV_SEARCH_SPANS; ++i) {
+        if (lwdtc_cron_next_with_cache(ctx, cache, curr_time - ((time_t)1 << (6U * i)), &time) != lwdtcOK) {
+            return 0; /* No fire time anymore */
+        }
+        if (time <= curr_time) {
+            break;
+        }
+    }
+    if (i > PRV_SEARCH_SPANS) {
+        return 0;
+    }
+
+    /* Move forward to the last one */
+    while (lwdtc_cron_next_with_cache(ctx, cache, time, &next) == lwdtcOK && next <= curr_time) {
+        time = next;
+    }
+    *last_time = time;
+    return 1;
+}
+
+/**
+ * \brief           Calculate window state at specific time, for window with close context
+ * 
+ * Window is open when open context fired after the last close fire time.
+ * When both fire at the same time, close takes precedence
+ * 
+ * \param[in,out]   win: Window object
+ * \param[in]       curr_time: Time to calculate state for
+ */
+static void
+prv_eval_close_ctx(lwdtc_window_t* win, time_t curr_time) {
+    time_t close_time, open_time;
+
+    if (prv_get_last(win->close_ctx, &win->close_cache, curr_time, &close_time)) {
+        if (lwdtc_cron_next_with_cache(win->open_ctx, &win->open_cache, close_time, &open_time) == lwdtcOK
+            && open_time <= curr_time) {
+            win->flags |= PRV_FLAG_OPEN;
+        }
+    } else if (prv_get_last(win->open_ctx, &win->open_cache, curr_time, &open_time)) {
+        win->flags |= PRV_FLAG_OPEN;
+    }
+
+    if (win->flags & PRV_FLAG_OPEN) {
+        /* Window closes at next close fire time */
+        if (lwdtc_cron_next_with_cache(win->close_ctx, &win->close_cache, curr_time, &win->edge) == lwdtcOK) {
+            win->flags |= PRV_FLAG_HAS_EDGE;
+        }
+    } else {
+        /*
+         * Window opens at next open fire time, when close does not fire at the same time.
+         *
+         * Number of checked open fire times is limited.
+         * State is then evaluated again at the edge, where window may stay closed
+         */
+        open_time = curr_time;
+        for (size_t i = 0;
+             i < PRV_EXTEND_MAX
+             && lwdtc_cron_next_with_cache(win->open_ctx, &win->open_cache, open_time, &open_time) == lwdtcOK;
+             ++i) {
+            win->flags |= PRV_FLAG_HAS_EDGE;
+            win->edge = open_time;
+            if (lwdtc_cron_next_with_cache(win->close_ctx, &win->close_cache, open_time - 1, &close_time) != lwdtcOK
+                || close_time != open_time) {
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * \brief           Calculate window state at specific time, for window with duration
+ * 
+ * Windows of open fire times that overlap are merged to one window
+ * 
+ * \param[in,out]   win: Window object
+ * \param[in]       curr_time: Time to calculate state for
+ */
+static void
+prv_eval_duration(lwdtc_window_t* win, time_t curr_time) {
+    time_t open_time, next_open;
+
+    /* First open fire time, that still covers current time */
+    if (lwdtc_cron_next_with_cache(win->open_ctx, &win->open_cache, curr_time - win->duration, &open_time)
+        != lwdtcOK) {
+        return;
+    }
+    win->flags |= PRV_FLAG_HAS_EDGE;
+    if (open_time > curr_time) {
+        win->edge = open_time;
+        return;
+    }
+
+    /*
+     * Window is open, extend it with open fire times before it closes.
+     *
+     * Number of extensions is limited, for windows that stay open for very long time.
+     * State is then evaluated again at the edge, where window may stay open
+     */
+    win->flags |= PRV_FLAG_OPEN;
+    win->edge = open_time + win->duration;
+    for (size_t i = 0; i < PRV_EXTEND_MAX
+                       && lwdtc_cron_next_with_cache(win->open_ctx, &win->open_cache, open_time, &next_open) == lwdtcOK
+                       && next_open <= win->edge;
+         ++i) {
+        open_time = next_open;
+        win->edge = open_time + win->duration;
+    }
+}
+
+/**
+ * \brief           Update window state for current time, if outside of interval with known state
+ * \param[in,out]   win: Window object
+ * \param[in]       curr_time: Current time
+ */
+static void
+prv_update(lwdtc_window_t* win, time_t curr_time) {
+    if ((win->flags & PRV_FLAG_VALID) && curr_time >= win->from
+        && (!(win->flags & PRV_FLAG_HAS_EDGE) || curr_time < win->edge)) {
+        return;
+    }
+    win->flags = PRV_FLAG_VALID;
+    win->from = curr_time;
+    if (win->close_ctx != NULL) {
+        prv_eval_close_ctx(win, curr_time);
+    } else {
+        prv_eval_duration(win, curr_time);
+    }
+}
+
+/**
+ * \brief           Initialize window with open and close contexts
+ * 
+ * Window is open from the time open context fires, until close context fires.
+ * When both fire at the same time, close takes precedence.
+ * Contexts must stay valid for the lifetime of the window
+ * 
+ * \param[out]      win: Window object
+ * \param[in]       open_ctx: Context that opens the window
+ * \param[in]       close_ctx: Context that closes the window
+ * \return          \ref lwdtcOK on success, member of \ref lwdtcr_t otherwise
+ */
+lwdtcr_t
+lwdtc_window_init(lwdtc_window_t* win, const lwdtc_cron_ctx_t* open_ctx, const lwdtc_cron_ctx_t* close_ctx) {
+    ASSERT_PARAM(win != NULL && open_ctx != NULL && close_ctx != NULL);
+
+    LWDTC_MEMSET(win, 0x00, sizeof(*win));
+    win->open_ctx = open_ctx;
+    win->close_ctx = close_ctx;
+    return lwdtcOK;
+}
+
+/**
+ * \brief           Initialize window with open context and fixed duration
+ * 
+ * Window is open from the time open context fires, for duration seconds.
+ * When open context fires again while window is open, window is extended.
+ * For windows extended many times, next edge may be a point where window stays open.
+ * Context must stay valid for the lifetime of the window
+ * 
+ * \param[out]      win: Window object
+ * \param[in]       open_ctx: Context that opens the window
+ * \param[in]       duration: Window duration in seconds, must be greater than `0`
+ * \return          \ref lwdtcOK on success, member of \ref lwdtcr_t otherwise
+ */
+lwdtcr_t
+lwdtc_window_init_duration(lwdtc_window_t* win, const lwdtc_cron_ctx_t* open_ctx, time_t duration) {
+    ASSERT_PARAM(win != NULL && open_ctx != NULL && duration > 0);
+
+    LWDTC_MEMSET(win, 0x00, sizeof(*win));
+    win->open_ctx = open_ctx;
+    win->duration = duration;
+    return lwdtcOK;
+}
+
+/**
+ * \brief           Check if window is open at current time
+ * 
+ * When time is within interval with known state, function only compares the time
+ * 
+ * \param[in,out]   win: Window object
+ * \param[in]       curr_time: Current time
+ * \return          `1` if window is open, `0` otherwise
+ */
+uint8_t
+lwdtc_window_is_active(lwdtc_window_t* win, time_t curr_time) {
+    ASSERT_WITH_RETURN(win != NULL, 0);
+
+    prv_update(win, curr_time);
+    return (win->flags & PRV_FLAG_OPEN) ? 1 : 0;
+}
+
+/**
+ * \brief           Get time of the next window transition, when window opens or closes
+ * 
+ * Application may sleep until that time, instead of polling the window state
+ * 
+ * \param[in,out]   win: Window object
+ * \param[in]       curr_time: Current time
+ * \param[out]      edge_time: Pointer to output time of next transition, always after current time
+ * \return          \ref lwdtcOK on success, \ref lwdtcERR if window state does not change anymore,
+ *                      member of \ref lwdtcr_t otherwise
+ */
+lwdtcr_t
+lwdtc_window_next_edge(lwdtc_window_t* win, time_t curr_time, time_t* edge_time) {
+    ASSERT_PARAM(win != NULL && edge_time != NULL);
+
+    prv_update(win, curr_time);
+    ASSERT_ACTION(win->flags & PRV_FLAG_HAS_EDGE);
+    *edge_time = win->edge;
+    return lwdtcOK;
+}
@@ -0,0 +1,599 @@
+/**
+ * \file            lwdtc_cli.c
+ * \brief           Command line tool for bulk cron evaluation
+ */
+
+/*
+ * Copyright (c) 2024 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwDTC - Lightweight Date, Time & Cron library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v1.0.0
+ */
+#define _GNU_SOURCE
+#include <fcntl.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include "lwdtc/lwdtc.h"
+
+#define CLI_CHUNK_SIZE   (1024U * 1024U) /*!< Input chunk size, processed by one worker at a time */
+#define CLI_THREADS_MAX  64              /*!< Maximum number of worker threads */
+#define CLI_LINE_OUT_MAX 64              /*!< Maximum output per line, per fire time */
+
+/**
+ * \brief           Processing mode
+ */
+typedef enum {
+    CLI_MODE_NEXT,  /*!< Input lines are cron strings, print next fire times */
+    CLI_MODE_MATCH, /*!< Input lines are cron strings, print if they match reference time */
+    CLI_MODE_AT,    /*!< Input lines are timestamps, print if cron matches and its next fire time */
+} cli_mode_t;
+
+/**
+ * \brief           Chunk slot state
+ */
+typedef enum {
+    CLI_SLOT_FREE,  /*!< Slot can be filled with new input */
+    CLI_SLOT_READY, /*!< Slot has input, waiting for worker */
+    CLI_SLOT_BUSY,  /*!< Worker processes the slot */
+    CLI_SLOT_DONE,  /*!< Output is ready to be written */
+} cli_slot_state_t;
+
+/**
+ * \brief           Input chunk and its output
+ */
+typedef struct {
+    cli_slot_state_t state; /*!< Slot state */
+    const char* in;         /*!< Input lines, complete lines only */
+    size_t in_len;          /*!< Input length */
+    char* in_buf;           /*!< Input buffer for stream input, `NULL` for mapped file */
+    size_t in_cap;          /*!< Input buffer capacity */
+    char* out;              /*!< Output buffer */
+    size_t out_len;         /*!< Output length */
+    size_t out_cap;         /*!< Output buffer capacity */
+} cli_slot_t;
+
+/* Configuration from command line */
+static cli_mode_t cli_mode = CLI_MODE_NEXT;
+static size_t cli_count = 1;
+static time_t cli_ref_time;
+static struct tm cli_ref_tm;
+static lwdtc_cron_ctx_t cli_at_ctx;
+static int cli_iso, cli_utc;
+
+/* Chunk pipeline, slots are used in sequence order */
+static pthread_mutex_t cli_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t cli_cond = PTHREAD_COND_INITIALIZER;
+static cli_slot_t cli_slots[2 * CLI_THREADS_MAX];
+static size_t cli_slots_num;
+static size_t cli_seq_in, cli_seq_take, cli_seq_out;
+static int cli_eof;
+
+/**
+ * \brief           Get broken-down time, used by the library
+ * \param[out]      tm_time: Broken-down time
+ * \param[in]       time: Time to convert
+ */
+void
+lwdtc_tool_get_time(struct tm* tm_time, const time_t* time) {
+    if (cli_utc) {
+        gmtime_r(time, tm_time);
+    } else {
+        localtime_r(time, tm_time);
+    }
+}
+
+/**
+ * \brief           Make sure output buffer has enough free space
+ * \param[in,out]   slot: Slot with output buffer
+ * \param[in]       len: Required free space
+ */
+static void
+prv_out_reserve(cli_slot_t* slot, size_t len) {
+    if (slot->out_len + len > slot->out_cap) {
+        slot->out_cap = (slot->out_len + len) * 2;
+        slot->out = realloc(slot->out, slot->out_cap);
+        if (slot->out == NULL) {
+            perror("realloc");
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+/**
+ * \brief           Write string to output buffer, space must be reserved
+ * \param[in,out]   slot: Slot with output buffer
+ * \param[in]       str: String to write
+ */
+static void
+prv_out_str(cli_slot_t* slot, const char* str) {
+    size_t len = strlen(str);
+
+    memcpy(&slot->out[slot->out_len], str, len);
+    slot->out_len += len;
+}
+
+/**
+ * \brief           Write number with fixed number of digits, space must be reserved
+ * \param[in,out]   slot: Slot with output buffer
+ * \param[in]       num: Number to write
+ * \param[in]       digits: Number of digits
+ */
+static void
+prv_out_num_fixed(cli_slot_t* slot, unsigned num, size_t digits) {
+    for (size_t i = digits; i > 0; --i, num /= 10U) {
+        slot->out[slot->out_len + i - 1] = (char)('0' + num % 10U);
+    }
+    slot->out_len += digits;
+}
+
+/**
+ * \brief           Write time to output buffer, as number of seconds or ISO 8601 date&time
+ * \param[in,out]   slot: Slot with output buffer
+ * \param[in]       time: Time to write
+ */
+static void
+prv_out_time(cli_slot_t* slot, time_t time) {
+    if (cli_iso) {
+        struct tm tm_time;
+
+        lwdtc_tool_get_time(&tm_time, &time);
+        prv_out_num_fixed(slot, (unsigned)tm_time.tm_year + 1900U, 4);
+        slot->out[slot->out_len++] = '-';
+        prv_out_num_fixed(slot, (unsigned)tm_time.tm_mon + 1U, 2);
+        slot->out[slot->out_len++] = '-';
+        prv_out_num_fixed(slot, (unsigned)tm_time.tm_mday, 2);
+        slot->out[slot->out_len++] = 'T';
+        prv_out_num_fixed(slot, (unsigned)tm_time.tm_hour, 2);
+        slot->out[slot->out_len++] = ':';
+        prv_out_num_fixed(slot, (unsigned)tm_time.tm_min, 2);
+        slot->out[slot->out_len++] = ':';
+        prv_out_num_fixed(slot, (unsigned)tm_time.tm_sec, 2);
+    } else {
+        char buf[24];
+        size_t len = 0;
+        unsigned long long val = time < 0 ? 0ULL - (unsigned long long)time : (unsigned long long)time;
+
+        do {
+            buf[len++] = (char)('0' + val % 10U);
+            val /= 10U;
+        } while (val > 0);
+        if (time < 0) {
+            slot->out[slot->out_len++] = '-';
+        }
+        while (len > 0) {
+            slot->out[slot->out_len++] = buf[--len];
+        }
+    }
+}
+
+/**
+ * \brief           Parse timestamp line
+ * \param[in]       line: Line to parse
+ * \param[in]       len: Line length
+ * \param[out]      time: Parsed time
+ * \return          `1` on success, `0` otherwise
+ */
+static int
+prv_parse_time(const char* line, size_t len, time_t* time) {
+    long long val = 0;
+    size_t i = 0;
+    int neg = 0;
+
+    if (len > 0 && line[0] == '-') {
+        neg = 1;
+        ++i;
+    }
+    if (i == len || len - i > 18) {
+        return 0;
+    }
+    for (; i < len; ++i) {
+        if (line[i] < '0' || line[i] > '9') {
+            return 0;
+        }
+        val = val * 10 + (line[i] - '0');
+    }
+    *time = (time_t)(neg ? -val : val);
+    return 1;
+}
+
+/**
+ * \brief           Process single input line and write its output line
+ * \param[in,out]   slot: Slot with output buffer
+ * \param[in]       line: Input line, without new line characters
+ * \param[in]       len: Line length
+ */
+static void
+prv_process_line(cli_slot_t* slot, const char* line, size_t len) {
+    lwdtc_cron_ctx_t ctx;
+    lwdtc_cron_daycache_t cache;
+    time_t time, next;
+
+    prv_out_reserve(slot, CLI_LINE_OUT_MAX * (cli_mode == CLI_MODE_NEXT ? cli_count : 2) + 1);
+    if (len == 0 || line[0] == '#') {
+        slot->out[slot->out_len++] = '\n';
+        return;
+    }
+    switch (cli_mode) {
+        case CLI_MODE_NEXT: {
+            if (lwdtc_cron_parse_with_len(&ctx, line, len) != lwdtcOK) {
+                prv_out_str(slot, "ERR");
+                break;
+            }
+            lwdtc_cron_daycache_reset(&cache);
+            time = cli_ref_time;
+            for (size_t i = 0; i < cli_count; ++i) {
+                if (lwdtc_cron_next_with_cache(&ctx, &cache, time, &time) != lwdtcOK) {
+                    if (i == 0) {
+                        prv_out_str(slot, "NEVER");
+                    }
+                    break;
+                }
+                if (i > 0) {
+                    slot->out[slot->out_len++] = ' ';
+                }
+                prv_out_time(slot, time);
+            }
+            break;
+        }
+        case CLI_MODE_MATCH: {
+            if (lwdtc_cron_parse_with_len(&ctx, line, len) != lwdtcOK) {
+                prv_out_str(slot, "ERR");
+                break;
+            }
+            prv_out_str(slot, lwdtc_cron_is_valid_for_time(&cli_ref_tm, &ctx) == lwdtcOK ? "1" : "0");
+            break;
+        }
+        case CLI_MODE_AT: {
+            struct tm tm_time;
+
+            if (!prv_parse_time(line, len, &time)) {
+                prv_out_str(slot, "ERR");
+                break;
+            }
+            lwdtc_tool_get_time(&tm_time, &time);
+            prv_out_str(slot, lwdtc_cron_is_valid_for_time(&tm_time, &cli_at_ctx) == lwdtcOK ? "1 " : "0 ");
+            if (lwdtc_cron_next(&cli_at_ctx, time, &next) == lwdtcOK) {
+                prv_out_time(slot, next);
+            } else {
+                prv_out_str(slot, "NEVER");
+            }
+            break;
+        }
+        default: break;
+    }
+    slot->out[slot->out_len++] = '\n';
+}
+
+/**
+ * \brief           Worker thread, processes chunks in any order
+ * \param[in]       arg: Not used
+ * \return          Not used
+ */
+static void*
+prv_worker_thread(void* arg) {
+    (void)arg;
+
+    while (1) {
+        cli_slot_t* slot;
+
+        pthread_mutex_lock(&cli_mutex);
+        while (cli_seq_take == cli_seq_in && !cli_eof) {
+            pthread_cond_wait(&cli_cond, &cli_mutex);
+        }
+        if (cli_seq_take == cli_seq_in) {
+            pthread_mutex_unlock(&cli_mutex);
+            break;
+        }
+        slot = &cli_slots[cli_seq_take++ % cli_slots_num];
+        slot->state = CLI_SLOT_BUSY;
+        pthread_mutex_unlock(&cli_mutex);
+
+        /* Process all lines of the chunk */
+        slot->out_len = 0;
+        for (const char *p = slot->in, *end = slot->in + slot->in_len; p < end;) {
+            const char* nl = memchr(p, '\n', (size_t)(end - p));
+            size_t len = (nl != NULL ? nl : end) - p;
+
+            prv_process_line(slot, p, len > 0 && p[len - 1] == '\r' ? len - 1 : len);
+            p += len + 1;
+        }
+
+        pthread_mutex_lock(&cli_mutex);
+        slot->state = CLI_SLOT_DONE;
+        pthread_cond_broadcast(&cli_cond);
+        pthread_mutex_unlock(&cli_mutex);
+    }
+    return NULL;
+}
+
+/**
+ * \brief           Writer thread, writes chunk outputs in input order
+ * \param[in]       arg: Not used
+ * \return          Not used
+ */
+static void*
+prv_writer_thread(void* arg) {
+    (void)arg;
+
+    while (1) {
+        cli_slot_t* slot;
+
+        pthread_mutex_lock(&cli_mutex);
+        while (!(cli_seq_out < cli_seq_in && cli_slots[cli_seq_out % cli_slots_num].state == CLI_SLOT_DONE)
+               && !(cli_eof && cli_seq_out == cli_seq_in)) {
+            pthread_cond_wait(&cli_cond, &cli_mutex);
+        }
+        if (cli_seq_out == cli_seq_in) {
+            pthread_mutex_unlock(&cli_mutex);
+            break;
+        }
+        slot = &cli_slots[cli_seq_out % cli_slots_num];
+        pthread_mutex_unlock(&cli_mutex);
+
+        fwrite(slot->out, 1, slot->out_len, stdout);
+
+        pthread_mutex_lock(&cli_mutex);
+        slot->state = CLI_SLOT_FREE;
+        ++cli_seq_out;
+        pthread_cond_broadcast(&cli_cond);
+        pthread_mutex_unlock(&cli_mutex);
+    }
+    fflush(stdout);
+    return NULL;
+}
+
+/**
+ * \brief           Get next free slot, waits for writer when all are in use
+ * \return          Free slot
+ */
+static cli_slot_t*
+prv_slot_get(void) {
+    cli_slot_t* slot;
+
+    pthread_mutex_lock(&cli_mutex);
+    slot = &cli_slots[cli_seq_in % cli_slots_num];
+    while (slot->state != CLI_SLOT_FREE) {
+        pthread_cond_wait(&cli_cond, &cli_mutex);
+    }
+    pthread_mutex_unlock(&cli_mutex);
+    return slot;
+}
+
+/**
+ * \brief           Submit filled slot to workers
+ */
+static void
+prv_slot_submit(void) {
+    pthread_mutex_lock(&cli_mutex);
+    cli_slots[cli_seq_in % cli_slots_num].state = CLI_SLOT_READY;
+    ++cli_seq_in;
+    pthread_cond_broadcast(&cli_cond);
+    pthread_mutex_unlock(&cli_mutex);
+}
+
+/**
+ * \brief           Split mapped file to chunks of complete lines, without copy
+ * \param[in]       data: File data
+ * \param[in]       len: File length
+ */
+static void
+prv_feed_mapped(const char* data, size_t len) {
+    while (len > 0) {
+        cli_slot_t* slot = prv_slot_get();
+        size_t chunk = len;
+
+        if (chunk > CLI_CHUNK_SIZE) {
+            const char* nl = memchr(data + CLI_CHUNK_SIZE, '\n', len - CLI_CHUNK_SIZE);
+            chunk = nl != NULL ? (size_t)(nl - data) + 1 : len;
+        }
+        slot->in = data;
+        slot->in_len = chunk;
+        prv_slot_submit();
+        data += chunk;
+        len -= chunk;
+    }
+}
+
+/**
+ * \brief           Read stream to chunks of complete lines
+ * \param[in]       fd: File descriptor to read from
+ */
+static void
+prv_feed_stream(int fd) {
+    char* carry = NULL;
+    size_t carry_len = 0, carry_cap = 0;
+    int eof = 0;
+
+    while (!eof) {
+        cli_slot_t* slot = prv_slot_get();
+        size_t len = carry_len;
+        char* nl;
+
+        /* Start with partial line from previous read */
+        if (slot->in_cap < carry_len + CLI_CHUNK_SIZE) {
+            slot->in_cap = carry_len + CLI_CHUNK_SIZE;
+            slot->in_buf = realloc(slot->in_buf, slot->in_cap);
+            if (slot->in_buf == NULL) {
+                perror("realloc");
+                exit(EXIT_FAILURE);
+            }
+        }
+        if (carry_len > 0) {
+            memcpy(slot->in_buf, carry, carry_len);
+        }
+
+        /* Fill the buffer */
+        while (len < slot->in_cap) {
+            ssize_t r = read(fd, slot->in_buf + len, slot->in_cap - len);
+            if (r <= 0) {
+                eof = 1;
+                break;
+            }
+            len += (size_t)r;
+        }
+
+        /* Keep partial last line for next chunk */
+        nl = eof ? NULL : memrchr(slot->in_buf, '\n', len);
+        slot->in = slot->in_buf;
+        slot->in_len = eof ? len : (nl != NULL ? (size_t)(nl - slot->in_buf) + 1 : 0);
+        carry_len = len - slot->in_len;
+        if (carry_len > carry_cap) {
+            carry_cap = carry_len * 2;
+            carry = realloc(carry, carry_cap);
+            if (carry == NULL) {
+                perror("realloc");
+                exit(EXIT_FAILURE);
+            }
+        }
+        if (carry_len > 0) {
+            memcpy(carry, slot->in_buf + slot->in_len, carry_len);
+        }
+        prv_slot_submit();
+    }
+    free(carry);
+}
+
+/**
+ * \brief           Print usage information
+ * \param[in]       name: Program name
+ */
+static void
+prv_usage(const char* name) {
+    fprintf(stderr,
+            "Usage: %s [options] [file]\n"
+            "Reads lines from file (mapped to memory) or from standard input when file is not set or is \"-\".\n"
+            "Writes one output line per input line, in the same order.\n"
+            "\n"
+            "  -m next   Lines are cron strings, print next fire times (default)\n"
+            "  -m match  Lines are cron strings, print 1 if cron matches reference time, 0 otherwise\n"
+            "  -m at     Lines are timestamps, print 1 or 0 if cron from -e matches, followed by its next fire time\n"
+            "  -e cron   Cron string for \"at\" mode\n"
+            "  -n count  Number of next fire times in \"next\" mode (default 1)\n"
+            "  -t time   Reference time in seconds since epoch (default current time)\n"
+            "  -j jobs   Number of worker threads (default number of CPUs)\n"
+            "  -i        Print times as ISO 8601 date and time instead of seconds since epoch\n"
+            "  -u        Use UTC instead of local time\n"
+            "\n"
+            "Invalid cron strings or timestamps print ERR, cron without next fire time prints NEVER.\n",
+            name);
+}
+
+int
+main(int argc, char** argv) {
+    pthread_t workers[CLI_THREADS_MAX], writer;
+    const char* at_cron = NULL;
+    long threads = sysconf(_SC_NPROCESSORS_ONLN);
+    int opt;
+
+    cli_ref_time = time(NULL);
+    while ((opt = getopt(argc, argv, "m:e:n:t:j:iuh")) != -1) {
+        switch (opt) {
+            case 'm':
+                if (strcmp(optarg, "next") == 0) {
+                    cli_mode = CLI_MODE_NEXT;
+                } else if (strcmp(optarg, "match") == 0) {
+                    cli_mode = CLI_MODE_MATCH;
+                } else if (strcmp(optarg, "at") == 0) {
+                    cli_mode = CLI_MODE_AT;
+                } else {
+                    prv_usage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'e': at_cron = optarg; break;
+            case 'n': cli_count = strtoul(optarg, NULL, 10); break;
+            case 't': cli_ref_time = (time_t)strtoll(optarg, NULL, 10); break;
+            case 'j': threads = strtol(optarg, NULL, 10); break;
+            case 'i': cli_iso = 1; break;
+            case 'u': cli_utc = 1; break;
+            default: prv_usage(argv[0]); return opt == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    if (cli_mode == CLI_MODE_AT && (at_cron == NULL || lwdtc_cron_parse(&cli_at_ctx, at_cron) != lwdtcOK)) {
+        fprintf(stderr, "Valid cron string must be set with -e in \"at\" mode\n");
+        return EXIT_FAILURE;
+    }
+    if (cli_count == 0) {
+        cli_count = 1;
+    }
+    if (threads < 1) {
+        threads = 1;
+    } else if (threads > CLI_THREADS_MAX) {
+        threads = CLI_THREADS_MAX;
+    }
+    if (!cli_utc) {
+        tzset();
+    }
+    lwdtc_tool_get_time(&cli_ref_tm, &cli_ref_time);
+
+    /* Start pipeline */
+    cli_slots_num = 2 * (size_t)threads;
+    for (long i = 0; i < threads; ++i) {
+        pthread_create(&workers[i], NULL, prv_worker_thread, NULL);
+    }
+    pthread_create(&writer, NULL, prv_writer_thread, NULL);
+
+    /* Feed input from mapped file or from the stream */
+    if (optind < argc && strcmp(argv[optind], "-") != 0) {
+        struct stat st;
+        int fd = open(argv[optind], O_RDONLY);
+        void* data;
+
+        if (fd < 0 || fstat(fd, &st) != 0) {
+            perror(argv[optind]);
+            return EXIT_FAILURE;
+        }
+        if (st.st_size > 0) {
+            data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED) {
+                perror("mmap");
+                return EXIT_FAILURE;
+            }
+            madvise(data, (size_t)st.st_size, MADV_SEQUENTIAL);
+            prv_feed_mapped(data, (size_t)st.st_size);
+        }
+    } else {
+        prv_feed_stream(STDIN_FILENO);
+    }
+
+    /* Wait for all to finish */
+    pthread_mutex_lock(&cli_mutex);
+    cli_eof = 1;
+    pthread_cond_broadcast(&cli_cond);
+    pthread_mutex_unlock(&cli_mutex);
+    for (long i = 0; i < threads; ++i) {
+        pthread_join(workers[i], NULL);
+    }
+    pthread_join(writer, NULL);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,674 @@
+/**
+ * \file            lwdtc_crond.c
+ * \brief           Reference cron daemon
+ */
+
+/*
+ * Copyright (c) 2024 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwDTC - Lightweight Date, Time & Cron library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v1.0.0
+ */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <getopt.h>
+#include <signal.h>
+#include <spawn.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include "lwdtc/lwdtc_reload.h"
+
+#define CROND_FIELDS     (5 + (LWDTC_CFG_FIELD_SEC ? 1 : 0) + (LWDTC_CFG_FIELD_YEAR ? 1 : 0))
+#define CROND_PRECISE_NS 2000000L /*!< Final part of the wait, done with precise sleep, in nanoseconds */
+#define CROND_NONE       UINT32_MAX
+
+/* Overlap policy, when job is due while its previous run is still running */
+#define CROND_OVERLAP_SKIP     0 /*!< Skip the run */
+#define CROND_OVERLAP_QUEUE    1 /*!< Run after previous run finishes, pending runs are coalesced */
+#define CROND_OVERLAP_PARALLEL 2 /*!< Run in parallel */
+
+/**
+ * \brief           Job, one per crontab entry
+ */
+typedef struct {
+    const lwdtc_reload_entry_t* entry; /*!< Table entry with context and line */
+    const char* cmd;                   /*!< Command, part of the line after cron fields */
+    size_t cmd_len;                    /*!< Command length */
+    time_t next;                       /*!< Next fire time, or `-1` when it never fires */
+    time_t queued;                     /*!< Scheduled time of the pending run, or `-1` when not pending */
+    uint32_t running;                  /*!< Number of running instances */
+    int last_status;                   /*!< Exit status of last finished run */
+    uint64_t runs;                     /*!< Number of started runs */
+    uint64_t skipped;                  /*!< Number of skipped runs */
+    uint64_t late_sum;                 /*!< Sum of start lateness in microseconds */
+    uint64_t late_max;                 /*!< Maximum start lateness in microseconds */
+    uint64_t run_sum;                  /*!< Sum of runtime in microseconds */
+    uint64_t run_max;                  /*!< Maximum runtime in microseconds */
+} crond_job_t;
+
+/**
+ * \brief           Running child process
+ */
+typedef struct {
+    pid_t pid;             /*!< Process ID, `0` when slot is free */
+    uint32_t id;           /*!< Entry ID of the job */
+    struct timespec start; /*!< Start time, monotonic */
+} crond_child_t;
+
+static const char* crond_path;
+static const char* crond_metrics_path;
+static int crond_utc, crond_dry, crond_overlap = CROND_OVERLAP_SKIP;
+static lwdtc_reload_t crond_table;
+static char* crond_text;
+static crond_job_t* jobs;
+static uint32_t jobs_len;
+static uint32_t* id_map; /* Entry ID to job index */
+static uint32_t id_map_len;
+static uint32_t *heap, heap_len; /* Jobs ordered by next fire time, min-heap */
+static uint32_t *fifo, fifo_cap, fifo_head, fifo_len; /* Entry IDs of pending runs, in a ring */
+static crond_child_t* children;
+static uint32_t children_max, children_num;
+
+/**
+ * \brief           Get broken-down time, used by the library
+ * \param[out]      tm_time: Broken-down time
+ * \param[in]       time: Time to convert
+ */
+void
+lwdtc_tool_get_time(struct tm* tm_time, const time_t* time) {
+    if (crond_utc) {
+        gmtime_r(time, tm_time);
+    } else {
+        localtime_r(time, tm_time);
+    }
+}
+
+/**
+ * \brief           Get difference between two times in microseconds
+ * \param[in]       a: Later time
+ * \param[in]       b: Earlier time
+ * \return          Difference in microseconds, `0` when `a` is before `b`
+ */
+static uint64_t
+prv_diff_us(const struct timespec* a, const struct timespec* b) {
+    int64_t us = ((int64_t)a->tv_sec - (int64_t)b->tv_sec) * 1000000 + (a->tv_nsec - b->tv_nsec) / 1000;
+
+    return us > 0 ? (uint64_t)us : 0;
+}
+
+/**
+ * \brief           Check if job `a` fires before job `b`
+ */
+static int
+prv_heap_before(uint32_t a, uint32_t b) {
+    return jobs[a].next < jobs[b].next || (jobs[a].next == jobs[b].next && a < b);
+}
+
+/**
+ * \brief           Move heap item down, until heap order is restored
+ * \param[in]       pos: Position of the item
+ */
+static void
+prv_heap_down(uint32_t pos) {
+    uint32_t item = heap[pos], child;
+
+    for (; (child = 2 * pos + 1) < heap_len; pos = child) {
+        if (child + 1 < heap_len && prv_heap_before(heap[child + 1], heap[child])) {
+            ++child;
+        }
+        if (!prv_heap_before(heap[child], item)) {
+            break;
+        }
+        heap[pos] = heap[child];
+    }
+    heap[pos] = item;
+}
+
+/**
+ * \brief           Start the job
+ * \param[in]       job: Job to start
+ * \param[in]       sched: Scheduled time of the run
+ */
+static void
+prv_start(crond_job_t* job, time_t sched) {
+    static posix_spawnattr_t attr;
+    static int attr_init;
+    struct timespec now, sched_ts = {sched, 0};
+    crond_child_t* child = NULL;
+    uint64_t late;
+    char* cmd;
+
+    clock_gettime(CLOCK_REALTIME, &now);
+    late = prv_diff_us(&now, &sched_ts);
+    ++job->runs;
+    job->late_sum += late;
+    job->late_max = late > job->late_max ? late : job->late_max;
+    if (crond_dry) {
+        job->last_status = 0;
+        return;
+    }
+
+    /* Child gets default signal handling and empty signal mask */
+    if (!attr_init) {
+        sigset_t set;
+
+        posix_spawnattr_init(&attr);
+        sigemptyset(&set);
+        posix_spawnattr_setsigmask(&attr, &set);
+        sigaddset(&set, SIGCHLD);
+        sigaddset(&set, SIGHUP);
+        sigaddset(&set, SIGTERM);
+        sigaddset(&set, SIGINT);
+        sigaddset(&set, SIGUSR1);
+        posix_spawnattr_setsigdefault(&attr, &set);
+        posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF);
+        attr_init = 1;
+    }
+    for (uint32_t i = 0; i < children_max; ++i) {
+        if (children[i].pid == 0) {
+            child = &children[i];
+            break;
+        }
+    }
+    if (child == NULL || (cmd = strndup(job->cmd, job->cmd_len)) == NULL) {
+        ++job->skipped;
+        return;
+    }
+    {
+        char* argv[] = {"sh", "-c", cmd, NULL};
+        int err = posix_spawn(&child->pid, "/bin/sh", NULL, &attr, argv, environ);
+
+        free(cmd);
+        if (err != 0) {
+            fprintf(stderr, "Cannot start job %u: %s\n", (unsigned)job->entry->id, strerror(err));
+            child->pid = 0;
+            job->last_status = -1;
+            return;
+        }
+    }
+    child->id = job->entry->id;
+    clock_gettime(CLOCK_MONOTONIC, &child->start);
+    ++job->running;
+    ++children_num;
+}
+
+/**
+ * \brief           Check if job may start now
+ * \param[in]       job: Job
+ * \return          `1` if it may start, `0` otherwise
+ */
+static int
+prv_can_start(const crond_job_t* job) {
+    return (crond_dry || children_num < children_max)
+           && (job->running == 0 || crond_overlap == CROND_OVERLAP_PARALLEL);
+}
+
+/**
+ * \brief           Job is due at scheduled time
+ * \param[in]       job: Job
+ * \param[in]       sched: Scheduled time
+ */
+static void
+prv_due(crond_job_t* job, time_t sched) {
+    if (job->queued >= 0) {
+        ++job->skipped; /* Coalesced with the pending run */
+    } else if (prv_can_start(job)) {
+        prv_start(job, sched);
+    } else if (job->running > 0 && crond_overlap == CROND_OVERLAP_SKIP) {
+        ++job->skipped;
+    } else {
+        /* Wait for free slot or for previous run */
+        job->queued = sched;
+        fifo[(fifo_head + fifo_len++) % fifo_cap] = job->entry->id;
+    }
+}
+
+/**
+ * \brief           Start pending runs, that may start now, in the order they became due
+ */
+static void
+prv_drain(void) {
+    for (uint32_t n = fifo_len; n > 0 && (crond_dry || children_num < children_max); --n) {
+        uint32_t id = fifo[fifo_head];
+        crond_job_t* job;
+
+        fifo_head = (fifo_head + 1) % fifo_cap;
+        --fifo_len;
+        if (id >= id_map_len || id_map[id] == CROND_NONE || (job = &jobs[id_map[id]])->queued < 0) {
+            continue; /* Job has been removed */
+        }
+        if (prv_can_start(job)) {
+            time_t sched = job->queued;
+
+            job->queued = -1;
+            prv_start(job, sched);
+        } else {
+            fifo[(fifo_head + fifo_len++) % fifo_cap] = id;
+        }
+    }
+}
+
+/**
+ * \brief           Collect finished child processes
+ */
+static void
+prv_reap(void) {
+    struct timespec now;
+    pid_t pid;
+    int status;
+
+    while ((pid = waitpid(-1, &status, WNOHANG)) > 0) {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        for (uint32_t i = 0; i < children_max; ++i) {
+            if (children[i].pid == pid) {
+                uint32_t id = children[i].id;
+
+                children[i].pid = 0;
+                --children_num;
+                if (id < id_map_len && id_map[id] != CROND_NONE) {
+                    crond_job_t* job = &jobs[id_map[id]];
+                    uint64_t run = prv_diff_us(&now, &children[i].start);
+
+                    --job->running;
+                    job->run_sum += run;
+                    job->run_max = run > job->run_max ? run : job->run_max;
+                    job->last_status = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+                }
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * \brief           Write metrics of all jobs
+ * \param[in]       f: Output file
+ */
+static void
+prv_metrics_write(FILE* f) {
+    uint64_t runs = 0, skipped = 0, late_sum = 0, late_max = 0;
+
+    fprintf(f, "# id\tline\truns\tskipped\tlate_avg_us\tlate_max_us\trun_avg_us\trun_max_us\tlast_status\tcommand\n");
+    for (uint32_t i = 0; i < jobs_len; ++i) {
+        const crond_job_t* job = &jobs[i];
+
+        fprintf(f, "%u\t%u\t%llu\t%llu\t%llu\t%llu\t%llu\t%llu\t%d\t%.*s\n", (unsigned)job->entry->id,
+                (unsigned)job->entry->line, (unsigned long long)job->runs, (unsigned long long)job->skipped,
+                (unsigned long long)(job->runs ? job->late_sum / job->runs : 0), (unsigned long long)job->late_max,
+                (unsigned long long)(job->runs > job->running ? job->run_sum / (job->runs - job->running) : 0),
+                (unsigned long long)job->run_max, job->last_status, (int)job->cmd_len, job->cmd);
+        runs += job->runs;
+        skipped += job->skipped;
+        late_sum += job->late_sum;
+        late_max = job->late_max > late_max ? job->late_max : late_max;
+    }
+    fprintf(f, "# jobs %u, runs %llu, skipped %llu, running %u, late_avg_us %llu, late_max_us %llu\n",
+            (unsigned)jobs_len, (unsigned long long)runs, (unsigned long long)skipped, (unsigned)children_num,
+            (unsigned long long)(runs ? late_sum / runs : 0), (unsigned long long)late_max);
+}
+
+/**
+ * \brief           Export metrics to the metrics file, or to standard output
+ */
+static void
+prv_metrics_export(void) {
+    FILE* f = stdout;
+    char tmp[4096];
+
+    /* Write to temporary file and rename it, so readers never see partial file */
+    if (crond_metrics_path != NULL) {
+        snprintf(tmp, sizeof(tmp), "%s.tmp", crond_metrics_path);
+        if ((f = fopen(tmp, "w")) == NULL) {
+            perror(tmp);
+            return;
+        }
+    }
+    prv_metrics_write(f);
+    if (crond_metrics_path != NULL) {
+        fclose(f);
+        if (rename(tmp, crond_metrics_path) != 0) {
+            perror(crond_metrics_path);
+        }
+    } else {
+        fflush(f);
+    }
+}
+
+/**
+ * \brief           Get command part of the line, after the cron fields
+ * \param[in]       str: Line
+ * \param[in]       len: Line length
+ * \param[out]      cmd_len: Command length
+ * \return          Pointer to command
+ */
+static const char*
+prv_get_cmd(const char* str, size_t len, size_t* cmd_len) {
+    size_t i = 0;
+
+    for (size_t f = 0; f < CROND_FIELDS; ++f) {
+        for (; i < len && (str[i] == ' ' || str[i] == '\t'); ++i) {}
+        for (; i < len && str[i] != ' ' && str[i] != '\t'; ++i) {}
+    }
+    for (; i < len && (str[i] == ' ' || str[i] == '\t'); ++i) {}
+    *cmd_len = len - i;
+    return &str[i];
+}
+
+/**
+ * \brief           Reload callback, marks jobs of changed entries
+ * \param[in]       evt: Change type
+ * \param[in]       entry: Entry
+ * \param[in]       arg: Number of changes
+ */
+static void
+prv_reload_evt(lwdtc_reload_evt_t evt, const lwdtc_reload_entry_t* entry, void* arg) {
+    /* Changed entry is new job with the same ID, it is rescheduled */
+    if (evt == LWDTC_RELOAD_CHANGED && entry->id < id_map_len && id_map[entry->id] != CROND_NONE) {
+        jobs[id_map[entry->id]].next = -2;
+    }
+    ++*(size_t*)arg;
+}
+
+/**
+ * \brief           Load crontab file and rebuild jobs.
+ *                  Jobs of unchanged entries keep their state and next fire time
+ * \return          `0` on success, `-1` otherwise
+ */
+static int
+prv_load(void) {
+    const lwdtc_reload_entry_t* entries;
+    crond_job_t* new_jobs;
+    size_t len = 0, cap = 1 << 16, r, fail_line = 0, changes = 0, entries_len;
+    uint32_t *new_map, *new_heap, *new_fifo, new_map_len, new_heap_len, new_fifo_len;
+    char *data = malloc(cap), *tmp;
+    time_t now = time(NULL);
+    FILE* f = fopen(crond_path, "rb");
+    lwdtcr_t res;
+
+    if (f == NULL || data == NULL) {
+        perror(crond_path);
+        if (f != NULL) {
+            fclose(f);
+        }
+        free(data);
+        return -1;
+    }
+    while ((r = fread(data + len, 1, cap - len, f)) > 0) {
+        len += r;
+        if (len == cap) {
+            if ((tmp = realloc(data, cap * 2)) == NULL) {
+                fprintf(stderr, "%s: out of memory, previous version is kept\n", crond_path);
+                fclose(f);
+                free(data);
+                return -1;
+            }
+            data = tmp;
+            cap *= 2;
+        }
+    }
+    fclose(f);
+    if ((res = lwdtc_reload_load(&crond_table, data, len, prv_reload_evt, &changes, &fail_line)) != lwdtcOK) {
+        fprintf(stderr, "%s:%u: %s, previous version is kept\n", crond_path, (unsigned)fail_line,
+                res == lwdtcERRTOKEN ? "invalid cron" : "too many entries");
+        free(data);
+        return -1;
+    }
+
+    /* Rebuild jobs, in the order of entries */
+    entries = lwdtc_reload_get_entries(&crond_table, &entries_len);
+    new_map_len = crond_table.next_id;
+    new_jobs = calloc(entries_len + 1, sizeof(*new_jobs));
+    new_map = malloc(new_map_len * sizeof(*new_map));
+    new_heap = malloc((entries_len + 1) * sizeof(*new_heap));
+    new_fifo = malloc((entries_len + 1) * sizeof(*new_fifo));
+    if (new_jobs == NULL || new_map == NULL || new_heap == NULL || new_fifo == NULL) {
+        perror("malloc");
+        exit(EXIT_FAILURE);
+    }
+    memset(new_map, 0xFF, new_map_len * sizeof(*new_map));
+    new_heap_len = 0;
+    for (uint32_t i = 0; i < entries_len; ++i) {
+        crond_job_t* job = &new_jobs[i];
+        uint32_t id = entries[i].id;
+
+        if (id < id_map_len && id_map[id] != CROND_NONE) {
+            *job = jobs[id_map[id]];
+        } else {
+            job->next = -2;
+            job->queued = -1;
+        }
+        job->entry = &entries[i];
+        job->cmd = prv_get_cmd(entries[i].str, entries[i].str_len, &job->cmd_len);
+        if (job->next == -2 && lwdtc_cron_next(&job->entry->ctx, now, &job->next) != lwdtcOK) {
+            job->next = -1;
+        }
+        if (job->next >= 0) {
+            new_heap[new_heap_len++] = i;
+        }
+        new_map[id] = i;
+    }
+
+    /* Pending runs of removed jobs are dropped */
+    new_fifo_len = 0;
+    for (uint32_t i = 0; i < fifo_len; ++i) {
+        uint32_t id = fifo[(fifo_head + i) % fifo_cap];
+
+        if (id < new_map_len && new_map[id] != CROND_NONE) {
+            new_fifo[new_fifo_len++] = id;
+        }
+    }
+
+    free(jobs);
+    free(id_map);
+    free(heap);
+    free(fifo);
+    jobs = new_jobs;
+    jobs_len = (uint32_t)entries_len;
+    id_map = new_map;
+    id_map_len = new_map_len;
+    heap = new_heap;
+    heap_len = new_heap_len;
+    fifo = new_fifo;
+    fifo_cap = jobs_len + 1;
+    fifo_head = 0;
+    fifo_len = new_fifo_len;
+    for (uint32_t i = heap_len / 2; i > 0; --i) {
+        prv_heap_down(i - 1);
+    }
+    free(crond_text);
+    crond_text = data;
+    fprintf(stderr, "Loaded %u jobs, %u changes\n", (unsigned)jobs_len, (unsigned)changes);
+    return 0;
+}
+
+/**
+ * \brief           Start runs of all jobs, that are due at current time,
+ *                  and schedule their next fire time
+ */
+static void
+prv_run_due(void) {
+    time_t now = time(NULL);
+
+    while (heap_len > 0 && jobs[heap[0]].next <= now) {
+        crond_job_t* job = &jobs[heap[0]];
+        time_t sched = job->next;
+
+        prv_due(job, sched);
+
+        /*
+         * Fire times missed while daemon was not running (suspend, clock step) are skipped,
+         * each of them is counted, up to and including current time
+         */
+        if (lwdtc_cron_next(&job->entry->ctx, sched, &job->next) != lwdtcOK) {
+            job->next = -1;
+        } else if (job->next < now) {
+            size_t missed = 0;
+
+            /* First missed fire time is start of the interval, not included in the count */
+            lwdtc_cron_count(&job->entry->ctx, job->next, now, &missed);
+            job->skipped += 1 + missed;
+            if (lwdtc_cron_next(&job->entry->ctx, now, &job->next) != lwdtcOK) {
+                job->next = -1;
+            }
+        }
+        if (job->next < 0) {
+            heap[0] = heap[--heap_len];
+        }
+        if (heap_len > 0) {
+            prv_heap_down(0);
+        }
+    }
+}
+
+/**
+ * \brief           Print usage
+ * \param[in]       name: Program name
+ */
+static void
+prv_usage(const char* name) {
+    fprintf(stderr,
+            "Usage: %s [-j jobs] [-o skip|queue|parallel] [-m metrics] [-n max] [-d] [-u] crontab\n"
+            "  -j  Maximum number of running jobs, default 64\n"
+            "  -o  Overlap policy, when job is due while it is still running, default skip\n"
+            "  -m  Metrics file, written on SIGUSR1 and on exit, standard output by default\n"
+            "  -n  Maximum number of entries, default 200000\n"
+            "  -d  Dry run, jobs are scheduled and measured, but commands are not started\n"
+            "  -u  Use UTC instead of local time\n"
+            "Crontab has one entry per line, %u cron fields followed by command.\n"
+            "SIGHUP reloads crontab, SIGUSR1 exports metrics.\n",
+            name, (unsigned)CROND_FIELDS);
+}
+
+/**
+ * \brief           Empty signal handler, so that blocked signal is kept pending
+ */
+static void
+prv_sig_nop(int sig) {
+    (void)sig;
+}
+
+int
+main(int argc, char* argv[]) {
+    lwdtc_reload_entry_t* entries;
+    uint32_t* scratch;
+    size_t max = 200000;
+    sigset_t set;
+    int opt;
+
+    children_max = 64;
+    while ((opt = getopt(argc, argv, "j:o:m:n:duh")) != -1) {
+        switch (opt) {
+            case 'j': children_max = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'm': crond_metrics_path = optarg; break;
+            case 'n': max = (size_t)strtoull(optarg, NULL, 0); break;
+            case 'd': crond_dry = 1; break;
+            case 'u': crond_utc = 1; break;
+            case 'o':
+                if (strcmp(optarg, "skip") == 0) {
+                    crond_overlap = CROND_OVERLAP_SKIP;
+                } else if (strcmp(optarg, "queue") == 0) {
+                    crond_overlap = CROND_OVERLAP_QUEUE;
+                } else if (strcmp(optarg, "parallel") == 0) {
+                    crond_overlap = CROND_OVERLAP_PARALLEL;
+                } else {
+                    prv_usage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+                break;
+            default: prv_usage(argv[0]); return opt == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    if (optind != argc - 1 || children_max == 0 || max == 0) {
+        prv_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    crond_path = argv[optind];
+    if (!crond_utc) {
+        tzset();
+    }
+
+    entries = malloc(2 * max * sizeof(*entries));
+    scratch = malloc(LWDTC_RELOAD_SCRATCH_LEN(max) * sizeof(*scratch));
+    children = calloc(children_max, sizeof(*children));
+    if (entries == NULL || scratch == NULL || children == NULL) {
+        perror("malloc");
+        return EXIT_FAILURE;
+    }
+    lwdtc_reload_init(&crond_table, entries, max, scratch);
+
+    /* Signals are blocked and only received in the wait */
+    sigemptyset(&set);
+    sigaddset(&set, SIGCHLD);
+    sigaddset(&set, SIGHUP);
+    sigaddset(&set, SIGTERM);
+    sigaddset(&set, SIGINT);
+    sigaddset(&set, SIGUSR1);
+    sigprocmask(SIG_BLOCK, &set, NULL);
+    signal(SIGCHLD, prv_sig_nop);
+
+    if (prv_load() != 0) {
+        return EXIT_FAILURE;
+    }
+    while (1) {
+        struct timespec now, deadline, timeout;
+        siginfo_t info;
+        int sig;
+
+        prv_reap();
+        prv_drain();
+        prv_run_due();
+
+        /* Wait for signal until shortly before the next fire time, then sleep precisely until it */
+        clock_gettime(CLOCK_REALTIME, &now);
+        if (heap_len > 0) {
+            deadline.tv_sec = jobs[heap[0]].next;
+            deadline.tv_nsec = 0;
+            timeout.tv_sec = deadline.tv_sec - now.tv_sec;
+            timeout.tv_nsec = -now.tv_nsec - CROND_PRECISE_NS;
+            while (timeout.tv_nsec < 0) {
+                timeout.tv_nsec += 1000000000L;
+                --timeout.tv_sec;
+            }
+            if (timeout.tv_sec < 0 || (sig = sigtimedwait(&set, &info, &timeout)) < 0) {
+                while (clock_nanosleep(CLOCK_REALTIME, TIMER_ABSTIME, &deadline, NULL) == EINTR) {}
+                continue;
+            }
+        } else if ((sig = sigwaitinfo(&set, &info)) < 0) {
+            continue;
+        }
+        switch (sig) {
+            case SIGHUP: prv_load(); break;
+            case SIGUSR1: prv_metrics_export(); break;
+            case SIGTERM:
+            case SIGINT: prv_metrics_export(); return EXIT_SUCCESS;
+            default: break; /* SIGCHLD, children are collected at the top of the loop */
+        }
+    }
+}
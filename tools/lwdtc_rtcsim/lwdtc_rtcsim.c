@@ -0,0 +1,273 @@
+/**
+ * \file            lwdtc_rtcsim.c
+ * \brief           Simulated RTC harness for alarm programming
+ */
+
+/*
+ * Copyright (c) 2024 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwDTC - Lightweight Date, Time & Cron library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v1.0.0
+ */
+#define _GNU_SOURCE
+#include <getopt.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "lwdtc/lwdtc_rtc.h"
+
+#define SIM_CTX_MAX 64 /*!< Maximum number of schedules */
+
+/**
+ * \brief           Simulated RTC with single alarm
+ */
+typedef struct {
+    time_t time;             /*!< Current time of the RTC calendar */
+    lwdtc_rtc_alarm_t alarm; /*!< Programmed alarm */
+    uint8_t hw_fields;       /*!< Fields compared by the alarm, `LWDTC_RTC_ALARM_x` */
+} sim_rtc_t;
+
+static int sim_utc, sim_verbose;
+
+/**
+ * \brief           Get broken-down time, used by the library
+ * \param[out]      tm_time: Broken-down time
+ * \param[in]       time: Time to convert
+ */
+void
+lwdtc_tool_get_time(struct tm* tm_time, const time_t* time) {
+    if (sim_utc) {
+        gmtime_r(time, tm_time);
+    } else {
+        localtime_r(time, tm_time);
+    }
+}
+
+/**
+ * \brief           Format time as ISO 8601 date and time
+ * \param[in]       time: Time to format
+ * \return          Pointer to static string
+ */
+static const char*
+prv_time_str(time_t time) {
+    static char str[32];
+    struct tm tm_time;
+
+    lwdtc_tool_get_time(&tm_time, &time);
+    strftime(str, sizeof(str), "%Y-%m-%dT%H:%M:%S", &tm_time);
+    return str;
+}
+
+/**
+ * \brief           Let RTC run until the alarm fires, or until the time limit.
+ *                  Alarm comparator is evaluated every second, as in the hardware
+ * \param[in,out]   rtc: Simulated RTC
+ * \param[in]       limit: Time limit
+ * \return          `1` if alarm fired, `0` if limit has been reached
+ */
+static int
+prv_rtc_sleep(sim_rtc_t* rtc, time_t limit) {
+    struct tm tm_time;
+
+    while (rtc->time < limit) {
+        ++rtc->time;
+        lwdtc_tool_get_time(&tm_time, &rtc->time);
+        if (lwdtc_rtc_alarm_is_match(&rtc->alarm, &tm_time)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * \brief           Parse alarm fields supported by the hardware
+ * \param[in]       str: Field letters
+ * \return          Bit-mask of `LWDTC_RTC_ALARM_x` fields
+ */
+static uint8_t
+prv_parse_fields(const char* str) {
+    uint8_t fields = 0;
+
+    for (; *str != '\0'; ++str) {
+        switch (*str) {
+            case 's': fields |= LWDTC_RTC_ALARM_SEC; break;
+            case 'm': fields |= LWDTC_RTC_ALARM_MIN; break;
+            case 'h': fields |= LWDTC_RTC_ALARM_HOUR; break;
+            case 'd': fields |= LWDTC_RTC_ALARM_MDAY; break;
+            case 'w': fields |= LWDTC_RTC_ALARM_WDAY; break;
+            default: break;
+        }
+    }
+    return fields;
+}
+
+/**
+ * \brief           Print usage information
+ * \param[in]       name: Program name
+ */
+static void
+prv_usage(const char* name) {
+    fprintf(stderr,
+            "Usage: %s [options] [file]\n"
+            "Reads cron strings, one per line, from file or from standard input when file is not set or is \"-\".\n"
+            "Runs simulated RTC, that sleeps from one alarm to the next, and checks that every fire time is hit.\n"
+            "\n"
+            "  -f time   Window start in seconds since epoch (default current time)\n"
+            "  -t time   Window end in seconds since epoch (default 30 days after start)\n"
+            "  -a fields Alarm fields compared by the RTC: s, m, h, d (day in month), w (week day) (default smhd)\n"
+            "  -e        RTC compares day in month or week day, but not both at once\n"
+            "  -v        Print every wake-up\n"
+            "  -u        Use UTC instead of local time\n"
+            "\n"
+            "Exit status is non-zero when alarm fires at unexpected time or any fire time is missed.\n",
+            name);
+}
+
+int
+main(int argc, char** argv) {
+    static lwdtc_cron_ctx_t ctx[SIM_CTX_MAX];
+    static char line[256];
+    size_t ctx_num = 0;
+    sim_rtc_t rtc;
+    lwdtc_rtc_alarm_t alarm;
+    time_t t_from = time(NULL), t_to = 0, expected;
+    uint64_t wakes = 0, fires = 0, programs = 0, errors = 0;
+    int opt;
+    FILE* f = stdin;
+
+    memset(&rtc, 0x00, sizeof(rtc));
+    rtc.hw_fields = LWDTC_RTC_ALARM_SEC | LWDTC_RTC_ALARM_MIN | LWDTC_RTC_ALARM_HOUR | LWDTC_RTC_ALARM_MDAY;
+    while ((opt = getopt(argc, argv, "f:t:a:evuh")) != -1) {
+        switch (opt) {
+            case 'f': t_from = (time_t)strtoll(optarg, NULL, 10); break;
+            case 't': t_to = (time_t)strtoll(optarg, NULL, 10); break;
+            case 'a': rtc.hw_fields = prv_parse_fields(optarg); break;
+            case 'e': rtc.hw_fields |= LWDTC_RTC_ALARM_DAY_EITHER; break;
+            case 'v': sim_verbose = 1; break;
+            case 'u': sim_utc = 1; break;
+            default: prv_usage(argv[0]); return opt == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    if (t_to == 0) {
+        t_to = t_from + 30 * 86400;
+    }
+    if (t_to <= t_from) {
+        fprintf(stderr, "Window end must be after window start\n");
+        return EXIT_FAILURE;
+    }
+    if (!sim_utc) {
+        tzset();
+    }
+
+    /* Read and parse all schedules */
+    if (optind < argc && strcmp(argv[optind], "-") != 0 && (f = fopen(argv[optind], "rb")) == NULL) {
+        perror(argv[optind]);
+        return EXIT_FAILURE;
+    }
+    while (fgets(line, sizeof(line), f) != NULL) {
+        size_t len = strcspn(line, "\r\n");
+
+        if (len == 0 || line[0] == '#') {
+            continue;
+        }
+        if (ctx_num == SIM_CTX_MAX) {
+            fprintf(stderr, "Too many schedules, maximum is %u\n", (unsigned)SIM_CTX_MAX);
+            return EXIT_FAILURE;
+        }
+        if (lwdtc_cron_parse_with_len(&ctx[ctx_num], line, len) != lwdtcOK) {
+            fprintf(stderr, "Invalid cron: %.*s\n", (int)len, line);
+            return EXIT_FAILURE;
+        }
+        ++ctx_num;
+    }
+    if (ctx_num == 0) {
+        fprintf(stderr, "No schedules\n");
+        return EXIT_FAILURE;
+    }
+
+    /*
+     * Device loop: program the alarm, sleep, wake-up.
+     *
+     * Expected fire times are calculated independently from the alarm,
+     * every one of them must be hit by the alarm in the same order
+     */
+    rtc.time = t_from;
+    if (lwdtc_cron_next_multi(ctx, ctx_num, t_from, &expected, NULL) != lwdtcOK) {
+        expected = t_to;
+    }
+    while (lwdtc_rtc_alarm_next(ctx, ctx_num, rtc.time, rtc.hw_fields, &alarm) == lwdtcOK) {
+        /* Repeating alarm stays in the hardware, as long as the settings are the same */
+        if (!rtc.alarm.is_repeat || memcmp(&rtc.alarm, &alarm, offsetof(lwdtc_rtc_alarm_t, is_repeat)) != 0) {
+            ++programs;
+        }
+        rtc.alarm = alarm;
+        if (!prv_rtc_sleep(&rtc, t_to)) {
+            break;
+        }
+        ++wakes;
+        if (rtc.time != alarm.time) {
+            printf("Error: alarm fired at %s", prv_time_str(rtc.time));
+            printf(", expected at %s\n", prv_time_str(alarm.time));
+            ++errors;
+        }
+        if (alarm.is_fire) {
+            ++fires;
+            if (rtc.time != expected) {
+                printf("Error: fired at %s", prv_time_str(rtc.time));
+                printf(", expected fire time %s\n", prv_time_str(expected));
+                ++errors;
+            }
+        } else if (rtc.time >= expected) {
+            printf("Error: fire time %s missed\n", prv_time_str(expected));
+            ++errors;
+        }
+        if (sim_verbose) {
+            printf("%s %s", prv_time_str(rtc.time), alarm.is_fire ? "fire" : "wake");
+            if (alarm.is_fire) {
+                printf(" %u", (unsigned)alarm.ctx_index);
+            }
+            printf("%s\n", alarm.is_repeat ? " repeat" : "");
+        }
+        if (rtc.time >= expected && lwdtc_cron_next_multi(ctx, ctx_num, rtc.time, &expected, NULL) != lwdtcOK) {
+            expected = t_to;
+        }
+    }
+    if (expected < t_to) {
+        printf("Error: fire time %s missed\n", prv_time_str(expected));
+        ++errors;
+    }
+
+    printf("Window: %s", prv_time_str(t_from));
+    printf(" - %s, %llu seconds\n", prv_time_str(t_to), (unsigned long long)(t_to - t_from));
+    printf("Schedules: %u\n", (unsigned)ctx_num);
+    printf("Wake-ups: %llu, fires: %llu, intermediate: %llu\n", (unsigned long long)wakes,
+           (unsigned long long)fires, (unsigned long long)(wakes - fires));
+    printf("Alarm programs: %llu\n", (unsigned long long)programs);
+    printf("Errors: %llu\n", (unsigned long long)errors);
+    return errors > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
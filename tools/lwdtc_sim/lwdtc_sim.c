@@ -0,0 +1,476 @@
+/**
+ * \file            lwdtc_sim.c
+ * \brief           Schedule simulator and load analyzer
+ */
+
+/*
+ * Copyright (c) 2024 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwDTC - Lightweight Date, Time & Cron library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v1.0.0
+ */
+#define _GNU_SOURCE
+#include <getopt.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "lwdtc/lwdtc.h"
+
+#define SIM_BUCKETS 34 /*!< Number of histogram buckets: 0, 1, 2-3, 4-7, ... */
+
+/* Check if second is set in the context, cron without seconds field fires at the beginning of the minute */
+#if LWDTC_CFG_FIELD_SEC
+#define SIM_SEC_IS_SET(ctx, sec) (((ctx)->sec[(sec) >> 3U] & (1U << ((sec) & 0x07U))) != 0)
+#else
+#define SIM_SEC_IS_SET(ctx, sec) ((sec) == 0)
+#endif /* LWDTC_CFG_FIELD_SEC */
+
+/**
+ * \brief           Group of schedules with equal context
+ */
+typedef struct {
+    lwdtc_cron_ctx_t ctx;        /*!< Parsed context */
+    lwdtc_cron_daycache_t cache; /*!< Day cache for next time search */
+    uint64_t weight;             /*!< Number of schedules in the group */
+    uint64_t fires;              /*!< Number of fire times of single schedule in the window */
+    time_t minute;               /*!< Start of next matching minute */
+} sim_group_t;
+
+/**
+ * \brief           Input schedule
+ */
+typedef struct {
+    lwdtc_cron_ctx_t ctx; /*!< Parsed context */
+    size_t line;          /*!< Input line index */
+} sim_entry_t;
+
+/**
+ * \brief           Second with its load, for hot-spot list
+ */
+typedef struct {
+    time_t time;   /*!< Time of the second */
+    uint64_t load; /*!< Number of fires in the second */
+} sim_hot_t;
+
+static int sim_utc;
+static sim_group_t* groups;
+static size_t* heap;
+static size_t heap_len;
+static sim_hot_t* hot;
+static size_t hot_len, hot_max = 10;
+static uint64_t hist_sec[SIM_BUCKETS], hist_min[SIM_BUCKETS];
+static sim_hot_t peak_sec, peak_min;
+
+/**
+ * \brief           Get broken-down time, used by the library
+ * \param[out]      tm_time: Broken-down time
+ * \param[in]       time: Time to convert
+ */
+void
+lwdtc_tool_get_time(struct tm* tm_time, const time_t* time) {
+    if (sim_utc) {
+        gmtime_r(time, tm_time);
+    } else {
+        localtime_r(time, tm_time);
+    }
+}
+
+/**
+ * \brief           Format time as ISO 8601 date and time
+ * \param[in]       time: Time to format
+ * \return          Pointer to static string
+ */
+static const char*
+prv_time_str(time_t time) {
+    static char str[32];
+    struct tm tm_time;
+
+    lwdtc_tool_get_time(&tm_time, &time);
+    strftime(str, sizeof(str), "%Y-%m-%dT%H:%M:%S", &tm_time);
+    return str;
+}
+
+/**
+ * \brief           Get histogram bucket for the value
+ * \param[in]       val: Value
+ * \return          `0` for zero, `1 + floor(log2(val))` otherwise
+ */
+static size_t
+prv_bucket(uint64_t val) {
+    size_t b = 0;
+
+    for (; val > 0 && b < SIM_BUCKETS - 1; val >>= 1U, ++b) {}
+    return b;
+}
+
+/**
+ * \brief           Compare entries by context, to group equal schedules
+ */
+static int
+prv_entry_cmp(const void* a, const void* b) {
+    return memcmp(&((const sim_entry_t*)a)->ctx, &((const sim_entry_t*)b)->ctx, sizeof(lwdtc_cron_ctx_t));
+}
+
+/**
+ * \brief           Restore min-heap order of groups by next minute, from position down
+ * \param[in]       pos: Heap position
+ */
+static void
+prv_heap_down(size_t pos) {
+    size_t item = heap[pos];
+
+    while (1) {
+        size_t child = 2 * pos + 1;
+
+        if (child >= heap_len) {
+            break;
+        }
+        if (child + 1 < heap_len && groups[heap[child + 1]].minute < groups[heap[child]].minute) {
+            ++child;
+        }
+        if (groups[heap[child]].minute >= groups[item].minute) {
+            break;
+        }
+        heap[pos] = heap[child];
+        pos = child;
+    }
+    heap[pos] = item;
+}
+
+/**
+ * \brief           Add second to hot-spot list, kept as min-heap by load
+ * \param[in]       time: Time of the second
+ * \param[in]       load: Number of fires in the second
+ */
+static void
+prv_hot_add(time_t time, uint64_t load) {
+    size_t pos;
+
+    if (hot_max == 0 || (hot_len == hot_max && load <= hot[0].load)) {
+        return;
+    }
+    if (hot_len < hot_max) {
+        /* Sift up new item */
+        for (pos = hot_len++; pos > 0 && hot[(pos - 1) / 2].load > load; pos = (pos - 1) / 2) {
+            hot[pos] = hot[(pos - 1) / 2];
+        }
+    } else {
+        /* Replace the smallest item and sift it down */
+        for (pos = 0;;) {
+            size_t child = 2 * pos + 1;
+
+            if (child >= hot_len) {
+                break;
+            }
+            if (child + 1 < hot_len && hot[child + 1].load < hot[child].load) {
+                ++child;
+            }
+            if (hot[child].load >= load) {
+                break;
+            }
+            hot[pos] = hot[child];
+            pos = child;
+        }
+    }
+    hot[pos].time = time;
+    hot[pos].load = load;
+}
+
+/**
+ * \brief           Compare hot-spot seconds, highest load first, then by time
+ */
+static int
+prv_hot_cmp(const void* a, const void* b) {
+    const sim_hot_t *ha = a, *hb = b;
+
+    if (ha->load != hb->load) {
+        return ha->load < hb->load ? 1 : -1;
+    }
+    return ha->time < hb->time ? -1 : (ha->time > hb->time);
+}
+
+/**
+ * \brief           Print histogram
+ * \param[in]       title: Histogram title
+ * \param[in]       hist: Histogram buckets
+ */
+static void
+prv_print_hist(const char* title, const uint64_t* hist) {
+    printf("%s:\n", title);
+    for (size_t b = 0; b < SIM_BUCKETS; ++b) {
+        if (hist[b] == 0) {
+            continue;
+        }
+        if (b <= 1) {
+            printf("  %20u: %llu\n", (unsigned)b, (unsigned long long)hist[b]);
+        } else {
+            char range[48];
+
+            snprintf(range, sizeof(range), "%llu-%llu", 1ULL << (b - 1), (1ULL << b) - 1);
+            printf("  %20s: %llu\n", range, (unsigned long long)hist[b]);
+        }
+    }
+}
+
+/**
+ * \brief           Read whole input to memory
+ * \param[in]       f: Input file
+ * \param[out]      len: Length of data
+ * \return          Data, `NUL` terminated
+ */
+static char*
+prv_read_all(FILE* f, size_t* len) {
+    size_t cap = 1 << 16, n = 0, r;
+    char *data = malloc(cap), *tmp;
+
+    if (data == NULL) {
+        perror("malloc");
+        exit(EXIT_FAILURE);
+    }
+    while ((r = fread(data + n, 1, cap - n - 1, f)) > 0) {
+        n += r;
+        if (cap - n - 1 == 0) {
+            if ((tmp = realloc(data, cap * 2)) == NULL) {
+                perror("realloc");
+                free(data);
+                exit(EXIT_FAILURE);
+            }
+            data = tmp;
+            cap *= 2;
+        }
+    }
+    data[n] = '\0';
+    *len = n;
+    return data;
+}
+
+/**
+ * \brief           Print usage information
+ * \param[in]       name: Program name
+ */
+static void
+prv_usage(const char* name) {
+    fprintf(stderr,
+            "Usage: %s [options] [file]\n"
+            "Reads cron strings, one per line, from file or from standard input when file is not set or is \"-\".\n"
+            "Plays back every fire time in the window and prints load statistics.\n"
+            "\n"
+            "  -f time   Window start in seconds since epoch (default current time)\n"
+            "  -t time   Window end in seconds since epoch (default one year after start)\n"
+            "  -k count  Number of top hot-spot seconds to print (default 10)\n"
+            "  -c        Print number of fire times of every schedule, by input line\n"
+            "  -u        Use UTC instead of local time\n"
+            "\n"
+            "Window is extended to whole minutes.\n",
+            name);
+}
+
+int
+main(int argc, char** argv) {
+    sim_entry_t* entries;
+    size_t* line_group;
+    size_t data_len, lines_num = 0, entries_num = 0, groups_num = 0, invalid = 0;
+    char* data;
+    time_t t_from = time(NULL), t_to = 0;
+    uint64_t total = 0, active_secs = 0, active_mins = 0;
+    int opt, print_counts = 0;
+    FILE* f = stdin;
+
+    while ((opt = getopt(argc, argv, "f:t:k:cuh")) != -1) {
+        switch (opt) {
+            case 'f': t_from = (time_t)strtoll(optarg, NULL, 10); break;
+            case 't': t_to = (time_t)strtoll(optarg, NULL, 10); break;
+            case 'k': hot_max = strtoul(optarg, NULL, 10); break;
+            case 'c': print_counts = 1; break;
+            case 'u': sim_utc = 1; break;
+            default: prv_usage(argv[0]); return opt == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    if (t_to == 0) {
+        t_to = t_from + 365 * 86400;
+    }
+    t_from -= t_from % 60;
+    t_to += (60 - t_to % 60) % 60;
+    if (t_to <= t_from) {
+        fprintf(stderr, "Window end must be after window start\n");
+        return EXIT_FAILURE;
+    }
+    if (!sim_utc) {
+        tzset();
+    }
+
+    /* Read and parse all schedules */
+    if (optind < argc && strcmp(argv[optind], "-") != 0 && (f = fopen(argv[optind], "rb")) == NULL) {
+        perror(argv[optind]);
+        return EXIT_FAILURE;
+    }
+    data = prv_read_all(f, &data_len);
+    for (size_t i = 0; i < data_len; ++i) {
+        lines_num += data[i] == '\n';
+    }
+    lines_num += data_len > 0 && data[data_len - 1] != '\n';
+    entries = calloc(lines_num + 1, sizeof(*entries));
+    line_group = calloc(lines_num + 1, sizeof(*line_group));
+    hot = calloc(hot_max + 1, sizeof(*hot));
+    if (entries == NULL || line_group == NULL || hot == NULL) {
+        perror("calloc");
+        return EXIT_FAILURE;
+    }
+    for (size_t line = 0, pos = 0; line < lines_num; ++line) {
+        char* nl = memchr(data + pos, '\n', data_len - pos);
+        size_t line_len = (nl != NULL ? (size_t)(nl - data) : data_len) - pos, len = line_len;
+
+        line_group[line] = SIZE_MAX;
+        if (len > 0 && data[pos + len - 1] == '\r') {
+            --len;
+        }
+        if (len > 0 && data[pos] != '#') {
+            if (lwdtc_cron_parse_with_len(&entries[entries_num].ctx, data + pos, len) == lwdtcOK) {
+                entries[entries_num++].line = line;
+            } else {
+                ++invalid;
+            }
+        }
+        pos += line_len + 1;
+    }
+
+    /* Group equal contexts, each group is simulated once */
+    qsort(entries, entries_num, sizeof(*entries), prv_entry_cmp);
+    groups = calloc(entries_num + 1, sizeof(*groups));
+    heap = calloc(entries_num + 1, sizeof(*heap));
+    if (groups == NULL || heap == NULL) {
+        perror("calloc");
+        return EXIT_FAILURE;
+    }
+    for (size_t i = 0; i < entries_num; ++i) {
+        if (i == 0 || prv_entry_cmp(&entries[i - 1], &entries[i]) != 0) {
+            groups[groups_num].ctx = entries[i].ctx;
+            lwdtc_cron_daycache_reset(&groups[groups_num].cache);
+            ++groups_num;
+        }
+        ++groups[groups_num - 1].weight;
+        line_group[entries[i].line] = groups_num - 1;
+    }
+
+    /* First matching minute of every group */
+    for (size_t g = 0; g < groups_num; ++g) {
+        time_t next;
+
+        if (lwdtc_cron_next_with_cache(&groups[g].ctx, &groups[g].cache, t_from - 1, &next) == lwdtcOK
+            && next < t_to) {
+            groups[g].minute = next - next % 60;
+            heap[heap_len++] = g;
+        }
+    }
+    for (size_t i = heap_len; i > 0; --i) {
+        prv_heap_down(i - 1);
+    }
+
+    /*
+     * Play back all fire times, one matching minute at a time.
+     *
+     * Cron is valid for whole matching minute, where seconds field matches,
+     * hence load of every second in the minute is updated at once
+     */
+    while (heap_len > 0) {
+        uint64_t load[LWDTC_SEC_MAX + 1] = {0}, min_load = 0;
+        time_t minute = groups[heap[0]].minute, next;
+
+        while (heap_len > 0 && groups[heap[0]].minute == minute) {
+            sim_group_t* grp = &groups[heap[0]];
+
+            for (uint32_t sec = 0; sec <= LWDTC_SEC_MAX; ++sec) {
+                if (SIM_SEC_IS_SET(&grp->ctx, sec)) {
+                    load[sec] += grp->weight;
+                    ++grp->fires;
+                }
+            }
+
+            /* Move to next matching minute, or remove from the heap */
+            if (lwdtc_cron_next_with_cache(&grp->ctx, &grp->cache, minute + LWDTC_SEC_MAX, &next) == lwdtcOK
+                && next < t_to) {
+                grp->minute = next - next % 60;
+            } else {
+                heap[0] = heap[--heap_len];
+            }
+            if (heap_len > 0) {
+                prv_heap_down(0);
+            }
+        }
+
+        /* Collect statistics of the minute */
+        for (uint32_t sec = 0; sec <= LWDTC_SEC_MAX; ++sec) {
+            if (load[sec] > 0) {
+                ++active_secs;
+                ++hist_sec[prv_bucket(load[sec])];
+                min_load += load[sec];
+                if (load[sec] > peak_sec.load) {
+                    peak_sec.load = load[sec];
+                    peak_sec.time = minute + sec;
+                }
+                prv_hot_add(minute + sec, load[sec]);
+            }
+        }
+        ++active_mins;
+        ++hist_min[prv_bucket(min_load)];
+        total += min_load;
+        if (min_load > peak_min.load) {
+            peak_min.load = min_load;
+            peak_min.time = minute;
+        }
+    }
+    hist_sec[0] = (uint64_t)(t_to - t_from) - active_secs;
+    hist_min[0] = (uint64_t)(t_to - t_from) / 60 - active_mins;
+
+    /* Print report */
+    printf("Window: %s", prv_time_str(t_from));
+    printf(" - %s, %llu seconds\n", prv_time_str(t_to), (unsigned long long)(t_to - t_from));
+    printf("Schedules: %llu valid, %llu distinct, %llu invalid\n", (unsigned long long)entries_num,
+           (unsigned long long)groups_num, (unsigned long long)invalid);
+    printf("Total fires: %llu\n", (unsigned long long)total);
+    if (total > 0) {
+        printf("Peak fires per second: %llu at %s\n", (unsigned long long)peak_sec.load, prv_time_str(peak_sec.time));
+        printf("Peak fires per minute: %llu at %s\n", (unsigned long long)peak_min.load, prv_time_str(peak_min.time));
+    }
+    prv_print_hist("Fires per second histogram (fires: seconds)", hist_sec);
+    prv_print_hist("Fires per minute histogram (fires: minutes)", hist_min);
+    qsort(hot, hot_len, sizeof(*hot), prv_hot_cmp);
+    printf("Top %u seconds:\n", (unsigned)hot_len);
+    for (size_t i = 0; i < hot_len; ++i) {
+        printf("  %s: %llu\n", prv_time_str(hot[i].time), (unsigned long long)hot[i].load);
+    }
+    if (print_counts) {
+        printf("Fires per schedule (line: fires):\n");
+        for (size_t line = 0; line < lines_num; ++line) {
+            if (line_group[line] != SIZE_MAX) {
+                printf("  %u: %llu\n", (unsigned)(line + 1), (unsigned long long)groups[line_group[line]].fires);
+            }
+        }
+    }
+    return EXIT_SUCCESS;
+}
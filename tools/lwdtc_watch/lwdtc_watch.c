@@ -0,0 +1,294 @@
+/**
+ * \file            lwdtc_watch.c
+ * \brief           Crontab file watcher with incremental reload
+ */
+
+/*
+ * Copyright (c) 2024 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwDTC - Lightweight Date, Time & Cron library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v1.0.0
+ */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <getopt.h>
+#include <libgen.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <time.h>
+#include <unistd.h>
+#include "lwdtc/lwdtc_reload.h"
+
+/**
+ * \brief           Reload statistics
+ */
+typedef struct {
+    size_t added;   /*!< Number of added entries */
+    size_t removed; /*!< Number of removed entries */
+    size_t changed; /*!< Number of changed entries */
+} watch_stat_t;
+
+static int watch_utc, watch_quiet;
+
+/**
+ * \brief           Get broken-down time, used by the library
+ * \param[out]      tm_time: Broken-down time
+ * \param[in]       time: Time to convert
+ */
+void
+lwdtc_tool_get_time(struct tm* tm_time, const time_t* time) {
+    if (watch_utc) {
+        gmtime_r(time, tm_time);
+    } else {
+        localtime_r(time, tm_time);
+    }
+}
+
+/**
+ * \brief           Format time as ISO 8601 date and time
+ * \param[in]       time: Time to format
+ * \return          Pointer to static string
+ */
+static const char*
+prv_time_str(time_t time) {
+    static char str[32];
+    struct tm tm_time;
+
+    lwdtc_tool_get_time(&tm_time, &time);
+    strftime(str, sizeof(str), "%Y-%m-%dT%H:%M:%S", &tm_time);
+    return str;
+}
+
+/**
+ * \brief           Get monotonic time in milliseconds
+ * \return          Time in milliseconds
+ */
+static double
+prv_now_ms(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e3 + (double)ts.tv_nsec / 1e6;
+}
+
+/**
+ * \brief           Read whole file to memory
+ * \param[in]       path: File path
+ * \param[out]      len: Length of data
+ * \return          Data, or `NULL` on failure
+ */
+static char*
+prv_read_file(const char* path, size_t* len) {
+    size_t cap = 1 << 16, n = 0, r;
+    char *data = malloc(cap), *tmp;
+    FILE* f = fopen(path, "rb");
+
+    if (f == NULL || data == NULL) {
+        perror(path);
+        if (f != NULL) {
+            fclose(f);
+        }
+        free(data);
+        return NULL;
+    }
+    while ((r = fread(data + n, 1, cap - n, f)) > 0) {
+        n += r;
+        if (n == cap) {
+            if ((tmp = realloc(data, cap * 2)) == NULL) {
+                perror("realloc");
+                free(data);
+                fclose(f);
+                return NULL;
+            }
+            data = tmp;
+            cap *= 2;
+        }
+    }
+    fclose(f);
+    *len = n;
+    return data;
+}
+
+/**
+ * \brief           Entry change callback, prints the change
+ * \param[in]       evt: Change type
+ * \param[in]       entry: Entry
+ * \param[in]       arg: Reload statistics
+ */
+static void
+prv_evt(lwdtc_reload_evt_t evt, const lwdtc_reload_entry_t* entry, void* arg) {
+    watch_stat_t* stat = arg;
+    time_t next;
+
+    switch (evt) {
+        case LWDTC_RELOAD_ADDED: ++stat->added; break;
+        case LWDTC_RELOAD_REMOVED: ++stat->removed; break;
+        default: ++stat->changed; break;
+    }
+    if (watch_quiet) {
+        return;
+    }
+    if (evt == LWDTC_RELOAD_REMOVED) {
+        printf("- %u\n", (unsigned)entry->id);
+        return;
+    }
+    printf("%c %u line %u: %.*s, next ", evt == LWDTC_RELOAD_ADDED ? '+' : '~', (unsigned)entry->id,
+           (unsigned)entry->line, (int)entry->str_len, entry->str);
+    if (lwdtc_cron_next(&entry->ctx, time(NULL), &next) == lwdtcOK) {
+        printf("%s\n", prv_time_str(next));
+    } else {
+        printf("NEVER\n");
+    }
+}
+
+/**
+ * \brief           Load file and apply it to the table
+ * \param[in,out]   reload: Table handle
+ * \param[in]       path: File path
+ * \param[in,out]   text: Text of current version, replaced with new text on success
+ */
+static void
+prv_load(lwdtc_reload_t* reload, const char* path, char** text) {
+    watch_stat_t stat = {0};
+    size_t len, fail_line = 0;
+    double start;
+    char* data;
+    lwdtcr_t res;
+
+    if ((data = prv_read_file(path, &len)) == NULL) {
+        return;
+    }
+    start = prv_now_ms();
+    res = lwdtc_reload_load(reload, data, len, prv_evt, &stat, &fail_line);
+    if (res != lwdtcOK) {
+        /* Previous version stays active, together with its text */
+        fprintf(stderr, "%s:%u: %s, previous version is kept\n", path, (unsigned)fail_line,
+                res == lwdtcERRTOKEN ? "invalid cron" : "too many entries");
+        free(data);
+        return;
+    }
+
+    /* Entries point to the new text now */
+    free(*text);
+    *text = data;
+    printf("Loaded %u entries in %.2f ms: %u added, %u removed, %u changed\n", (unsigned)reload->entries_len,
+           prv_now_ms() - start, (unsigned)stat.added, (unsigned)stat.removed, (unsigned)stat.changed);
+    fflush(stdout);
+}
+
+/**
+ * \brief           Print usage information
+ * \param[in]       name: Program name
+ */
+static void
+prv_usage(const char* name) {
+    fprintf(stderr,
+            "Usage: %s [options] file\n"
+            "Loads crontab file, with cron string and optional command per line, and watches it for changes.\n"
+            "On every change, only changed lines are parsed. Added (+), removed (-) and changed (~) entries\n"
+            "are printed with their IDs, that stay the same while entry exists.\n"
+            "\n"
+            "  -n num    Maximum number of entries (default 200000)\n"
+            "  -q        Print only reload summary\n"
+            "  -u        Use UTC instead of local time\n",
+            name);
+}
+
+int
+main(int argc, char** argv) {
+    static char events[16 * (sizeof(struct inotify_event) + NAME_MAX + 1)];
+    lwdtc_reload_entry_t* entries;
+    lwdtc_reload_t reload;
+    uint32_t* scratch;
+    size_t entries_max = 200000;
+    char *text = NULL, *path, *dir_buf, *name_buf;
+    const char *dir, *name;
+    int opt, fd;
+
+    while ((opt = getopt(argc, argv, "n:quh")) != -1) {
+        switch (opt) {
+            case 'n': entries_max = (size_t)strtoull(optarg, NULL, 10); break;
+            case 'q': watch_quiet = 1; break;
+            case 'u': watch_utc = 1; break;
+            default: prv_usage(argv[0]); return opt == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    if (optind >= argc || entries_max == 0) {
+        prv_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (!watch_utc) {
+        tzset();
+    }
+    path = argv[optind];
+    entries = malloc(2 * entries_max * sizeof(*entries));
+    scratch = malloc(LWDTC_RELOAD_SCRATCH_LEN(entries_max) * sizeof(*scratch));
+    dir_buf = strdup(path);
+    name_buf = strdup(path);
+    if (entries == NULL || scratch == NULL || dir_buf == NULL || name_buf == NULL
+        || lwdtc_reload_init(&reload, entries, entries_max, scratch) != lwdtcOK) {
+        fprintf(stderr, "Cannot allocate table for %u entries\n", (unsigned)entries_max);
+        return EXIT_FAILURE;
+    }
+
+    /*
+     * Watch the directory, not the file itself.
+     * Editors often write new file and rename it over the old one
+     */
+    dir = dirname(dir_buf);
+    name = basename(name_buf);
+    if ((fd = inotify_init1(IN_CLOEXEC)) < 0 || inotify_add_watch(fd, dir, IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        perror(dir);
+        return EXIT_FAILURE;
+    }
+    prv_load(&reload, path, &text);
+    for (;;) {
+        ssize_t len = read(fd, events, sizeof(events));
+        int changed = 0;
+
+        if (len < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("inotify");
+            return EXIT_FAILURE;
+        }
+        for (char* p = events; p < events + len;) {
+            const struct inotify_event* ev = (const struct inotify_event*)p;
+
+            if (ev->len > 0 && strcmp(ev->name, name) == 0) {
+                changed = 1;
+            }
+            p += sizeof(*ev) + ev->len;
+        }
+        if (changed) {
+            prv_load(&reload, path, &text);
+        }
+    }
+}